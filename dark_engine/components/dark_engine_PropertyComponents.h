@@ -24,7 +24,11 @@ public:
     /** @internal */
     void handleAsyncUpdate() override                       { populateButtons(); }
     /** @internal */
-    void languageChanged (const IETFLanguageFile&) override { triggerAsyncUpdate(); }
+    void languageChanged (const IETFLanguageFile&) override
+    {
+        LocalisedStringTable::refreshAll();
+        triggerAsyncUpdate();
+    }
 
     /** @internal */
     void resized() override
@@ -43,10 +47,24 @@ private:
         return VariantConverter<StructureType>::fromVar (value.getValue());
     }
 
+    uint32 populatedGeneration = 0;
+
     void populateButtons()
     {
         static const Identifier buttonIndexId = "buttonIndex";
 
+        // The names come from LocalisedStringTables, so the buttons only need
+        // remaking when the language has changed since they were made.
+        const auto generation = LocalisedStringTable::getGeneration();
+
+        if (buttons.size() == numFlags && populatedGeneration == generation)
+        {
+            updateToggleStates();
+            return;
+        }
+
+        populatedGeneration = generation;
+
         grid.items.clearQuick();
         grid.templateRows.clearQuick();
         buttons.clearQuick (true);
@@ -71,9 +89,18 @@ private:
             grid.templateRows.add (Grid::TrackInfo (1_fr));
         }
 
+        updateToggleStates();
         resized();
     }
 
+    void updateToggleStates()
+    {
+        const auto bits = getValueAsStructure().toBitset();
+
+        for (int i = 0; i < buttons.size(); ++i)
+            buttons.getUnchecked (i)->setToggleState (bits.test ((size_t) i), dontSendNotification);
+    }
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FlagTickerPropertyComponent)
 };
 
@@ -98,18 +125,31 @@ public:
     FlagType fromIndex (int index) const                    { return static_cast<FlagType> (index); }
     void refresh() override                                 { triggerAsyncUpdate(); }
     void handleAsyncUpdate() override                       { populateComboBox(); }
-    void languageChanged (const IETFLanguageFile&) override { triggerAsyncUpdate(); }
+    void languageChanged (const IETFLanguageFile&) override
+    {
+        LocalisedStringTable::refreshAll();
+        triggerAsyncUpdate();
+    }
 
 private:
     Value value;
     ComboBox comboBox;
+    uint32 populatedGeneration = 0;
 
     void populateComboBox()
     {
-        comboBox.clear();
+        // The names come from LocalisedStringTables, so the items only need
+        // remaking when the language has changed since they were added.
+        const auto generation = LocalisedStringTable::getGeneration();
 
-        for (int i = 0; i < numFlags; ++i)
-            comboBox.addItem (darkEngine::toString (fromIndex (i)), i + 1);
+        if (comboBox.getNumItems() != numFlags || populatedGeneration != generation)
+        {
+            populatedGeneration = generation;
+            comboBox.clear (dontSendNotification);
+
+            for (int i = 0; i < numFlags; ++i)
+                comboBox.addItem (darkEngine::toString (fromIndex (i)), i + 1);
+        }
 
         comboBox.setSelectedId (static_cast<int> (value.getValue()) + 1, dontSendNotification);
         repaint();
@@ -351,10 +391,10 @@ private:
     public:
         DoorLockStatePropertyComponent (const Value& valueToControl,
                                         const String& propertyName) :
-            ChoicePropertyComponent (valueToControl, propertyName, states, indices),
+            ChoicePropertyComponent (valueToControl, propertyName, getStates(), indices),
             value (valueToControl)
         {
-            choices = states;
+            choices = getStates();
         }
 
         /** @internal */
@@ -365,13 +405,17 @@ private:
     private:
         Value value;
 
-        static inline const StringArray states =
+        /** In the current language, rather than whichever was current when the statics were made. */
+        static StringArray getStates()
         {
-            darkEngine::toString (DoorLockState::unlocked),
-            darkEngine::toString (DoorLockState::needsKey),
-            darkEngine::toString (DoorLockState::needsSpell),
-            darkEngine::toString (DoorLockState::impassable)
-        };
+            return
+            {
+                darkEngine::toString (DoorLockState::unlocked),
+                darkEngine::toString (DoorLockState::needsKey),
+                darkEngine::toString (DoorLockState::needsSpell),
+                darkEngine::toString (DoorLockState::impassable)
+            };
+        }
 
         static inline const Array<var> indices =
         {
@@ -425,10 +469,10 @@ private:
     public:
         WindowTileTypePropertyComponent (const Value& valueToControl,
                                          const String& propertyName) :
-            ChoicePropertyComponent (valueToControl, propertyName, states, indices),
+            ChoicePropertyComponent (valueToControl, propertyName, getStates(), indices),
             value (valueToControl)
         {
-            choices = states;
+            choices = getStates();
         }
 
         /** @internal */
@@ -439,13 +483,17 @@ private:
     private:
         Value value;
 
-        static inline const StringArray states =
+        /** In the current language, rather than whichever was current when the statics were made. */
+        static StringArray getStates()
         {
-            darkEngine::toString (WindowTileType::permanentlyOpen),
-            darkEngine::toString (WindowTileType::permanentlyClosed),
-            darkEngine::toString (WindowTileType::openable),
-            darkEngine::toString (WindowTileType::openableWithUnlockableId)
-        };
+            return
+            {
+                darkEngine::toString (WindowTileType::permanentlyOpen),
+                darkEngine::toString (WindowTileType::permanentlyClosed),
+                darkEngine::toString (WindowTileType::openable),
+                darkEngine::toString (WindowTileType::openableWithUnlockableId)
+            };
+        }
 
         static inline const Array<var> indices =
         {
@@ -462,3 +510,113 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WindowTileTypePropertyParser)
 };
 
+
+//==============================================================================
+/** Presents a packed property (see PropertyConverter) as the text of its older format,
+    and packs any text written to it back.
+*/
+template<typename Type>
+class PackedPropertyValueSource final : public Value::ValueSource,
+                                        private Value::Listener
+{
+public:
+    /** */
+    PackedPropertyValueSource (const Value& valueToControl) :
+        source (valueToControl)
+    {
+        source.addListener (this);
+    }
+
+    /** */
+    ~PackedPropertyValueSource() override
+    {
+        source.removeListener (this);
+    }
+
+    /** @returns */
+    static String toText (const var& packed)
+    {
+        return juce::VariantConverter<Type>::toVar (PropertyConverter<Type>::fromVar (packed)).toString();
+    }
+
+    /** @internal */
+    var getValue() const override               { return toText (source.getValue()); }
+    /** @internal */
+    void setValue (const var& newValue) override
+    {
+        source = PropertyConverter<Type>::toVar (PropertyConverter<Type>::fromVar (newValue.toString()));
+    }
+
+private:
+    Value source;
+
+    void valueChanged (Value&) override         { sendChangeMessage (true); }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PackedPropertyValueSource)
+};
+
+//==============================================================================
+/** Dimensions */
+class DimensionsPropertyParser final : public PropertyParser
+{
+public:
+    /** */
+    DimensionsPropertyParser() = default;
+
+    /** @internal */
+    bool canUnderstand (const ValueTree&, const Identifier& id, const var&) const override
+    {
+        return id == dimensionsId;
+    }
+
+    /** @internal */
+    String toString (const Identifier&, const var& prop) const override
+    {
+        return PackedPropertyValueSource<Rectangle<int>>::toText (prop);
+    }
+
+    /** @internal */
+    std::unique_ptr<PropertyComponent> createPropertyComponent (const Value& valueToControl,
+                                                                const Identifier&,
+                                                                const String& propertyName) const override
+    {
+        return std::make_unique<TextPropertyComponent> (Value (new PackedPropertyValueSource<Rectangle<int>> (valueToControl)),
+                                                        propertyName, 64, false);
+    }
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DimensionsPropertyParser)
+};
+
+//==============================================================================
+/** Colour */
+class ColourPropertyParser final : public PropertyParser
+{
+public:
+    /** */
+    ColourPropertyParser() = default;
+
+    /** @internal */
+    bool canUnderstand (const ValueTree&, const Identifier& id, const var&) const override
+    {
+        return id == colourId || id == lightColourId;
+    }
+
+    /** @internal */
+    String toString (const Identifier&, const var& prop) const override
+    {
+        return PackedPropertyValueSource<Colour>::toText (prop);
+    }
+
+    /** @internal */
+    std::unique_ptr<PropertyComponent> createPropertyComponent (const Value& valueToControl,
+                                                                const Identifier&,
+                                                                const String& propertyName) const override
+    {
+        return std::make_unique<TextPropertyComponent> (Value (new PackedPropertyValueSource<Colour> (valueToControl)),
+                                                        propertyName, 16, false);
+    }
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ColourPropertyParser)
+};
@@ -1,9 +1,33 @@
 #include "dark_engine.h"
 
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define DARK_ENGINE_USE_SSE2 1
+    #include <emmintrin.h>
+#else
+    #define DARK_ENGINE_USE_SSE2 0
+#endif
+
+#if JUCE_LINUX || JUCE_MAC || JUCE_BSD
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+#endif
+
 namespace darkEngine
 {
     using namespace juce;
     using namespace sp;
 
     #include "model/dark_engine_IDs.cpp"
+    #include "model/dark_engine_BinarySnapshot.cpp"
+    #include "mechanics/dark_engine_ContentLoader.cpp"
+    #include "mechanics/dark_engine_CommandJournal.cpp"
+    #include "mechanics/dark_engine_StatusEngine.cpp"
+    #include "mechanics/dark_engine_DamageBatch.cpp"
+    #include "mechanics/dark_engine_BattleSimulator.cpp"
+    #include "mechanics/dark_engine_MoveSelector.cpp"
+    #include "mechanics/dark_engine_SessionHost.cpp"
 }
@@ -11,14 +11,33 @@
     website:            https://www.jrlanglois.io
     license:            Beerware
     minimumCppStandard: 20
-    dependencies:       squarepine_graphics
+    dependencies:       juce_graphics, squarepine_core
 
     END_JUCE_MODULE_DECLARATION
 */
 
 //==============================================================================
-#include <squarepine_audio/squarepine_audio.h>
-#include <squarepine_graphics/squarepine_graphics.h>
+/** Config: DARK_ENGINE_ENABLE_COMPONENTS
+
+    Enables the PropertyComponents used to edit engine state in a GUI,
+    which need the squarepine_graphics module, and the GUI modules it brings in.
+    Disable this for headless builds, like the console runner,
+    that only need the model and mechanics and can leave those modules out.
+*/
+#ifndef DARK_ENGINE_ENABLE_COMPONENTS
+    #define DARK_ENGINE_ENABLE_COMPONENTS 1
+#endif
+
+//==============================================================================
+#include <juce_graphics/juce_graphics.h>
+#include <squarepine_core/squarepine_core.h>
+
+#if DARK_ENGINE_ENABLE_COMPONENTS
+    #include <squarepine_graphics/squarepine_graphics.h>
+#endif
+
+#include <bit>
+#include <span>
 
 //==============================================================================
 namespace darkEngine
@@ -26,7 +45,12 @@ namespace darkEngine
     using namespace sp;  
 
     #include "static_data/dark_engine_Verbs.h"
+    #include "static_data/dark_engine_VerbTable.h"
+    #include "static_data/dark_engine_LocalisedStringTable.h"
     #include "model/dark_engine_IDs.h"
+    #include "model/dark_engine_PropertyConverters.h"
+    #include "model/dark_engine_CachedProperty.h"
+    #include "model/dark_engine_BinarySnapshot.h"
     #include "model/dark_engine_Core.h"
 }
 
@@ -36,13 +60,36 @@ namespace darkEngine
 {
     using namespace sp;
 
+    #include "model/dark_engine_WorldTicker.h"
     #include "model/dark_engine_Entities.h"
+    #include "model/dark_engine_Views.h"
+    #include "model/dark_engine_CombatTables.h"
+    #include "model/dark_engine_SpatialIndex.h"
+    #include "model/dark_engine_DefinitionIndex.h"
+    #include "model/dark_engine_NameIndex.h"
+    #include "model/dark_engine_StatusIndex.h"
+    #include "model/dark_engine_TileGrid.h"
+    #include "model/dark_engine_FieldOfView.h"
     #include "model/dark_engine_Screen.h"
 
     #include "mechanics/dark_engine_GameEngine.h"
+    #include "mechanics/dark_engine_ContentLoader.h"
+    #include "mechanics/dark_engine_WorldManager.h"
+    #include "mechanics/dark_engine_StatusEngine.h"
+    #include "mechanics/dark_engine_DamageBatch.h"
+    #include "mechanics/dark_engine_BattleModel.h"
+    #include "mechanics/dark_engine_BattleSimulator.h"
+    #include "mechanics/dark_engine_TurnScheduler.h"
+    #include "mechanics/dark_engine_MoveSelector.h"
+    #include "mechanics/dark_engine_CommandTokenizer.h"
+    #include "mechanics/dark_engine_CommandTable.h"
+    #include "mechanics/dark_engine_CommandJournal.h"
     #include "mechanics/dark_engine_GameProcessor.h"
+    #include "mechanics/dark_engine_SessionHost.h"
 
+   #if DARK_ENGINE_ENABLE_COMPONENTS
     #include "components/dark_engine_PropertyComponents.h"
+   #endif
 }
 
 #endif // JRLANGLOIS_DARK_ENGINE_H
@@ -0,0 +1,111 @@
+//==============================================================================
+/** A FightingMove, as plain data for running battles quickly.
+
+    @see BattleCombatant, BattleSimulator, MoveSelector
+*/
+struct BattleMove final
+{
+    MoveType type = MoveType::normal;
+    bool isSpecial = false;
+    int power = 0, accuracy = 100, priority = 0, maxPowerPoints = 0;
+
+    /** */
+    static BattleMove from (const FightingMoveView& view)
+    {
+        const auto category = view.getMoveCategory();
+        const auto doesDamage = category == MoveCategory::physical || category == MoveCategory::special;
+
+        BattleMove m;
+        m.type = view.getMoveType();
+        m.isSpecial = category == MoveCategory::special;
+        m.power = doesDamage ? jlimit (0, DamageBatch::maxPower, view.getPower()) : 0;
+        m.accuracy = view.getAccuracy();
+        m.priority = view.getPriority();
+        m.maxPowerPoints = jmax (0, view.getMaxPowerPoints());
+        return m;
+    }
+
+    /** @returns the move used when there are no power points left for any other. */
+    static const BattleMove& struggle()
+    {
+        static const auto m = []
+        {
+            BattleMove s;
+            s.power = 40;
+            return s;
+        }();
+
+        return m;
+    }
+};
+
+//==============================================================================
+/** A FightableEntity's stats and moves, as plain data for running battles quickly,
+    with its nature already applied and everything clamped like DamageBatch does.
+
+    @see BattleMove, BattleSimulator, MoveSelector
+*/
+struct BattleCombatant final
+{
+    int level = 1, maxHitPoints = 1, attack = 1, defense = 1, specialAttack = 1, specialDefense = 1, speed = 1;
+    MoveType weakAgainstType = MoveType::normal;
+    std::vector<BattleMove> moves;
+
+    /** */
+    static BattleCombatant from (const ValueTree& state, const ValueTree& prototype = {})
+    {
+        const FightableEntityView view (state, prototype);
+        const auto nature = view.getNature();
+
+        const auto stat = [nature] (int value, Stat s)
+        {
+            return jlimit (1, DamageBatch::maxStat, CombatTables::applyNature (value, nature, s));
+        };
+
+        BattleCombatant c;
+        c.level = jlimit (1, DamageBatch::maxLevel, view.getLevel());
+        c.maxHitPoints = jmax (1, view.getMaxHitPoints());
+        c.attack = stat (view.getAttack(), Stat::attack);
+        c.defense = stat (view.getDefense(), Stat::defense);
+        c.specialAttack = stat (view.getSpecialAttack(), Stat::specialAttack);
+        c.specialDefense = stat (view.getSpecialDefense(), Stat::specialDefense);
+        c.speed = stat (view.getSpeed(), Stat::speed);
+        c.weakAgainstType = view.getWeakAgainstType();
+
+        for (int i = 0; i < view.getNumFightingMoves(); ++i)
+            c.moves.push_back (BattleMove::from (FightingMoveView (view.getFightingMoveState (i))));
+
+        return c;
+    }
+
+    /** @returns the move at the index, or the struggle move for any other index. */
+    [[nodiscard]] const BattleMove& getMove (int index) const noexcept
+    {
+        return isPositiveAndBelow (index, (int) moves.size()) ? moves[(size_t) index] : BattleMove::struggle();
+    }
+
+    //==============================================================================
+    /** @returns the damage of an attack, drawing the random factor and hit roll. */
+    [[nodiscard]] int attackWith (const BattleMove& move, const BattleCombatant& defender, Random& random) const
+    {
+        const auto randomPercent = random.nextInt (Range<int> (DamageBatch::minRandomPercent, DamageBatch::maxRandomPercent + 1));
+        const auto hitRoll = random.nextInt (100);
+
+        return DamageBatch::calculateDamage (level, move.power,
+                                             move.isSpecial ? specialAttack : attack,
+                                             move.isSpecial ? defender.specialDefense : defender.defense,
+                                             CombatTables::getEffectiveness (move.type, defender.weakAgainstType),
+                                             randomPercent, hitRoll, move.accuracy);
+    }
+
+    /** @returns true if this, using its move, acts before the other using theirs:
+        by priority, then speed, then a coin toss.
+    */
+    [[nodiscard]] bool actsBefore (const BattleMove& move, const BattleCombatant& other,
+                                   const BattleMove& otherMove, Random& random) const
+    {
+        if (move.priority != otherMove.priority)    return move.priority > otherMove.priority;
+        if (speed != other.speed)                   return speed > other.speed;
+        return random.nextBool();
+    }
+};
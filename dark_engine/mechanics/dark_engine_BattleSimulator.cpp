@@ -0,0 +1,247 @@
+//==============================================================================
+double BattleSimulator::Report::getWinRate() const noexcept
+{
+    return numBattles > 0 ? (double) numWins / (double) numBattles : 0.0;
+}
+
+double BattleSimulator::Report::getMeanTurnsToKill() const noexcept
+{
+    if (numWins <= 0)
+        return 0.0;
+
+    int64 total = 0;
+
+    for (size_t turns = 0; turns < turnsToKill.size(); ++turns)
+        total += (int64) turns * turnsToKill[turns];
+
+    return (double) total / (double) numWins;
+}
+
+int BattleSimulator::Report::getTurnsToKillPercentile (double fraction) const noexcept
+{
+    if (numWins <= 0)
+        return 0;
+
+    const auto target = jmax ((int64) 1, (int64) std::ceil (jlimit (0.0, 1.0, fraction) * (double) numWins));
+    int64 count = 0;
+
+    for (size_t turns = 0; turns < turnsToKill.size(); ++turns)
+    {
+        count += turnsToKill[turns];
+
+        if (count >= target)
+            return (int) turns;
+    }
+
+    return (int) turnsToKill.size() - 1;
+}
+
+void BattleSimulator::Report::merge (const Report& other)
+{
+    numBattles += other.numBattles;
+    numWins += other.numWins;
+    numLosses += other.numLosses;
+    numDraws += other.numDraws;
+
+    if (turnsToKill.size() < other.turnsToKill.size())
+        turnsToKill.resize (other.turnsToKill.size());
+
+    for (size_t i = 0; i < other.turnsToKill.size(); ++i)
+        turnsToKill[i] += other.turnsToKill[i];
+
+    for (int i = 0; i < numHitPointBuckets; ++i)
+    {
+        remainingHitPointsOnWin[(size_t) i] += other.remainingHitPointsOnWin[(size_t) i];
+        enemyHitPointsOnLoss[(size_t) i] += other.enemyHitPointsOnLoss[(size_t) i];
+    }
+}
+
+//==============================================================================
+/** Runs a chunk of the battles against one enemy, only touching its own report. */
+class BattleSimulator::ChunkJob final : public ThreadPoolJob
+{
+public:
+    ChunkJob (const BattleCombatant& buildToUse, const BattleCombatant& enemyToUse,
+              int numBattlesToRun, int maxTurnsToUse, int64 seed) :
+        ThreadPoolJob ("Battle Simulation"),
+        build (buildToUse),
+        enemy (enemyToUse),
+        numBattles (numBattlesToRun),
+        maxTurns (maxTurnsToUse),
+        random (seed)
+    {
+        report.turnsToKill.resize ((size_t) maxTurns + 1);
+    }
+
+    JobStatus runJob() override
+    {
+        for (int i = 0; i < numBattles; ++i)
+            fight();
+
+        return jobHasFinished;
+    }
+
+    Report report;
+
+private:
+    const BattleCombatant& build;
+    const BattleCombatant& enemy;
+    const int numBattles, maxTurns;
+    Random random;
+
+    std::vector<int> buildPowerPoints, enemyPowerPoints;
+
+    //==============================================================================
+    void fight()
+    {
+        ++report.numBattles;
+
+        resetPowerPoints (build, buildPowerPoints);
+        resetPowerPoints (enemy, enemyPowerPoints);
+
+        int buildHitPoints = build.maxHitPoints, enemyHitPoints = enemy.maxHitPoints;
+
+        for (int turn = 1; turn <= maxTurns; ++turn)
+        {
+            const auto& buildMove = pickMove (build, buildPowerPoints);
+            const auto& enemyMove = pickMove (enemy, enemyPowerPoints);
+
+            const auto buildFirst = build.actsBefore (buildMove, enemy, enemyMove, random);
+
+            const auto buildAttacks = [&]
+            {
+                enemyHitPoints -= build.attackWith (buildMove, enemy, random);
+                return enemyHitPoints <= 0;
+            };
+
+            const auto enemyAttacks = [&]
+            {
+                buildHitPoints -= enemy.attackWith (enemyMove, build, random);
+                return buildHitPoints <= 0;
+            };
+
+            const auto isOver = buildFirst ? (buildAttacks() || enemyAttacks())
+                                           : (enemyAttacks() || buildAttacks());
+
+            if (! isOver)
+                continue;
+
+            if (enemyHitPoints <= 0)
+            {
+                ++report.numWins;
+                ++report.turnsToKill[(size_t) turn];
+                ++report.remainingHitPointsOnWin[(size_t) getBucket (buildHitPoints, build.maxHitPoints)];
+            }
+            else
+            {
+                ++report.numLosses;
+                ++report.enemyHitPointsOnLoss[(size_t) getBucket (enemyHitPoints, enemy.maxHitPoints)];
+            }
+
+            return;
+        }
+
+        ++report.numDraws;
+    }
+
+    const BattleMove& pickMove (const BattleCombatant& combatant, std::vector<int>& powerPoints)
+    {
+        int numUsable = 0;
+
+        for (const auto pp : powerPoints)
+            if (pp > 0)
+                ++numUsable;
+
+        if (numUsable == 0)
+            return BattleMove::struggle();
+
+        auto pick = random.nextInt (numUsable);
+
+        for (size_t i = 0; i < powerPoints.size(); ++i)
+        {
+            if (powerPoints[i] > 0 && pick-- == 0)
+            {
+                --powerPoints[i];
+                return combatant.moves[i];
+            }
+        }
+
+        jassertfalse;
+        return BattleMove::struggle();
+    }
+
+    static void resetPowerPoints (const BattleCombatant& combatant, std::vector<int>& powerPoints)
+    {
+        powerPoints.resize (combatant.moves.size());
+
+        for (size_t i = 0; i < powerPoints.size(); ++i)
+            powerPoints[i] = combatant.moves[i].maxPowerPoints;
+    }
+
+    static int getBucket (int hitPoints, int maxHitPoints) noexcept
+    {
+        return jlimit (0, numHitPointBuckets - 1, hitPoints * numHitPointBuckets / jmax (1, maxHitPoints));
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ChunkJob)
+};
+
+//==============================================================================
+BattleSimulator::BattleSimulator (int numThreads) :
+    pool (jmax (1, numThreads))
+{
+}
+
+std::vector<BattleSimulator::Report> BattleSimulator::run (const ValueTree& build, const ValueTree& enemies,
+                                                           const Options& options)
+{
+    // The number of battles that each job runs, which is fixed so that the results
+    // only depend on the seed and not on how the work is spread out.
+    constexpr int battlesPerChunk = 4096;
+
+    const auto maxTurns = jmax (1, options.maxTurns);
+    const auto buildCombatant = BattleCombatant::from (build);
+
+    std::vector<BattleCombatant> enemyCombatants;
+    std::vector<Report> reports;
+
+    for (const auto& definition : enemies)
+    {
+        enemyCombatants.push_back (BattleCombatant::from (definition));
+
+        Report report;
+        report.enemyName = definition[nameId].toString();
+        report.turnsToKill.resize ((size_t) maxTurns + 1);
+        reports.push_back (std::move (report));
+    }
+
+    OwnedArray<ChunkJob> jobs;
+    std::vector<size_t> jobEnemies;
+
+    for (size_t e = 0; e < enemyCombatants.size(); ++e)
+    {
+        for (int first = 0, chunk = 0; first < options.battlesPerEnemy; first += battlesPerChunk, ++chunk)
+        {
+            // SplitMix64 of the seed and the chunk's position, so every chunk gets its own stream:
+            auto z = (uint64) options.seed + ((uint64) e << 32 | (uint64) chunk) * 0x9e3779b97f4a7c15ull;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            z ^= z >> 31;
+
+            auto* job = jobs.add (new ChunkJob (buildCombatant, enemyCombatants[e],
+                                                jmin (battlesPerChunk, options.battlesPerEnemy - first),
+                                                maxTurns, (int64) z));
+            jobEnemies.push_back (e);
+            pool.addJob (job, false);
+        }
+    }
+
+    for (int i = 0; i < jobs.size(); ++i)
+    {
+        auto* job = jobs.getUnchecked (i);
+        pool.waitForJobToFinish (job, -1);
+        reports[jobEnemies[(size_t) i]].merge (job->report);
+    }
+
+    return reports;
+}
@@ -0,0 +1,82 @@
+//==============================================================================
+/** Pits a fightable build, like the player's, against every enemy definition
+    many times over, for balancing the game's numbers.
+
+    The build and the enemies are first read into plain structs, so the
+    battles themselves never touch a ValueTree. The battles are then split
+    into fixed-size chunks, each run as a job on the pool with its own random
+    number generator, seeded from the simulation's seed and the chunk's
+    position, and each tallied into its own report. Nothing is shared between
+    the jobs while they run, and the reports are merged in order afterwards,
+    so the results only depend on the seed, never on the number of threads.
+
+    Each battle is one on one: every turn, both sides pick one of their moves
+    that has power points left at random (or struggle with a default move if
+    none do), and act in order of the move's priority, then speed, with ties
+    decided by a coin toss. The damage is worked out just like DamageBatch does.
+
+    @see BattleCombatant, DamageBatch, ContentLoader
+*/
+class BattleSimulator final
+{
+public:
+    /** */
+    explicit BattleSimulator (int numThreads = SystemStats::getNumCpus());
+
+    //==============================================================================
+    /** */
+    struct Options final
+    {
+        int battlesPerEnemy = 10000;
+        int maxTurns = 100;         // A battle that lasts longer is a draw.
+        int64 seed = 0;
+    };
+
+    /** The number of buckets that the remaining hit points are tallied in, each a tenth of the max. */
+    static constexpr int numHitPointBuckets = 10;
+
+    /** The outcome of every battle against one enemy. */
+    struct Report final
+    {
+        String enemyName;
+        int64 numBattles = 0, numWins = 0, numLosses = 0, numDraws = 0;
+
+        /** The number of wins that took each number of turns. */
+        std::vector<int64> turnsToKill;
+
+        /** The build's remaining hit points when it won, in tenths of its max. */
+        std::array<int64, numHitPointBuckets> remainingHitPointsOnWin {};
+        /** The enemy's remaining hit points when it won, in tenths of its max. */
+        std::array<int64, numHitPointBuckets> enemyHitPointsOnLoss {};
+
+        /** @returns the fraction of battles won. */
+        [[nodiscard]] double getWinRate() const noexcept;
+        /** @returns the average number of turns that a win took. */
+        [[nodiscard]] double getMeanTurnsToKill() const noexcept;
+        /** @returns the number of turns that the fraction of wins took no more than. */
+        [[nodiscard]] int getTurnsToKillPercentile (double fraction) const noexcept;
+
+        /** Adds another report's tallies to this one's. */
+        void merge (const Report&);
+    };
+
+    //==============================================================================
+    /** Runs the battles against every enemy, blocking until they're all done.
+
+        @param build    The state of a FightableEntity, like Player::getState(),
+                        whose fighting moves are used.
+        @param enemies  The enemy definitions, like GameMap::getEnemiesState().
+
+        @returns a report per enemy, in the order of the definitions.
+    */
+    [[nodiscard]] std::vector<Report> run (const ValueTree& build, const ValueTree& enemies, const Options& options);
+
+private:
+    //==============================================================================
+    class ChunkJob;
+
+    ThreadPool pool;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BattleSimulator)
+};
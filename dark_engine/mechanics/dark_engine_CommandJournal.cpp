@@ -0,0 +1,187 @@
+namespace
+{
+    constexpr char journalMagic[] = { 'D', 'k', 'J', 'n' };
+
+    /** Guards against a corrupt length asking for an absurd amount of memory. */
+    constexpr int maxJournalCommandLength = 1 << 20;
+
+    /** The length written in place of a command's, for a tick without one. */
+    constexpr int tickOnlyLength = -1;
+}
+
+//==============================================================================
+void CommandJournal::append (uint64 tick, std::string_view command)
+{
+    // Ticks must never go backwards, or the journal can't be replayed!
+    jassert (getLastTick() <= tick);
+
+    entries.add ({ tick, text.size(), command.size() });
+    text.append (command);
+
+    if (stream != nullptr)
+    {
+        writeEntry (*stream, tick, command);
+        lastWrittenTick = tick;
+    }
+}
+
+void CommandJournal::markTick (uint64 tick)
+{
+    // Ticks must never go backwards, or the journal can't be replayed!
+    jassert (getLastTick() <= tick);
+
+    lastTick = tick;
+}
+
+//==============================================================================
+void CommandJournal::startWritingTo (std::unique_ptr<OutputStream> output)
+{
+    stopWriting();
+
+    stream = std::move (output);
+
+    if (stream != nullptr)
+    {
+        write (*stream);
+        lastWrittenTick = getLastTick();
+    }
+}
+
+void CommandJournal::stopWriting()
+{
+    flush();
+    stream.reset();
+}
+
+void CommandJournal::flush()
+{
+    if (stream == nullptr)
+        return;
+
+    if (lastTick > lastWrittenTick)
+    {
+        writeTick (*stream, lastTick);
+        lastWrittenTick = lastTick;
+    }
+
+    stream->flush();
+}
+
+//==============================================================================
+void CommandJournal::writeHeader (OutputStream& output) const
+{
+    output.write (journalMagic, sizeof (journalMagic));
+    output.writeShort (static_cast<short> (currentVersion));
+    output.writeInt64 (seed);
+}
+
+void CommandJournal::writeEntry (OutputStream& output, uint64 tick, std::string_view command)
+{
+    output.writeInt64 (static_cast<int64> (tick));
+    output.writeCompressedInt (static_cast<int> (command.size()));
+    output.write (command.data(), command.size());
+}
+
+void CommandJournal::writeTick (OutputStream& output, uint64 tick)
+{
+    output.writeInt64 (static_cast<int64> (tick));
+    output.writeCompressedInt (tickOnlyLength);
+}
+
+void CommandJournal::write (OutputStream& output) const
+{
+    writeHeader (output);
+
+    for (int i = 0; i < entries.size(); ++i)
+        writeEntry (output, getTick (i), getCommand (i));
+
+    if (entries.isEmpty() ? lastTick > 0 : lastTick > entries.getLast().tick)
+        writeTick (output, lastTick);
+}
+
+Result CommandJournal::save (const File& destination) const
+{
+    TemporaryFile temp (destination);
+
+    {
+        FileOutputStream output (temp.getFile());
+
+        if (! output.openedOk())
+            return Result::fail (TRANS ("Failed to save!"));
+
+        write (output);
+        output.flush();
+
+        if (output.getStatus().failed())
+            return output.getStatus();
+    }
+
+    if (temp.overwriteTargetFileWithTemporary())
+        return Result::ok();
+
+    return Result::fail (TRANS ("Failed to save!"));
+}
+
+//==============================================================================
+Result CommandJournal::read (InputStream& input)
+{
+    char magic[sizeof (journalMagic)] = {};
+
+    if (input.read (magic, sizeof (magic)) != (int) sizeof (magic)
+        || std::memcmp (magic, journalMagic, sizeof (magic)) != 0)
+        return Result::fail (TRANS ("This isn't a command journal!"));
+
+    const auto version = static_cast<int> (input.readShort());
+    if (version <= 0 || version > currentVersion)
+        return Result::fail (TRANS ("This command journal was made by a newer version of the game!"));
+
+    stopWriting();
+    clear();
+    seed = input.readInt64();
+
+    std::string command;
+
+    for (;;)
+    {
+        char tickBytes[sizeof (int64)];
+        if (input.read (tickBytes, (int) sizeof (tickBytes)) != (int) sizeof (tickBytes))
+            break; // The end, or cut short.
+
+        const auto tick = static_cast<uint64> (ByteOrder::littleEndianInt64 (tickBytes));
+        const auto length = input.readCompressedInt();
+
+        if (length == 0)
+            break; // Cut short, since empty commands are never recorded.
+
+        if (getLastTick() > tick)
+            return Result::fail (TRANS ("The command journal is corrupt!"));
+
+        if (length == tickOnlyLength && version >= 2)
+        {
+            markTick (tick);
+            continue;
+        }
+
+        if (! isPositiveAndNotGreaterThan (length, maxJournalCommandLength))
+            return Result::fail (TRANS ("The command journal is corrupt!"));
+
+        command.resize ((size_t) length);
+
+        if (input.read (command.data(), length) != length)
+            break; // Cut short.
+
+        append (tick, command);
+    }
+
+    return Result::ok();
+}
+
+Result CommandJournal::load (const File& source)
+{
+    FileInputStream input (source);
+
+    if (! input.openedOk())
+        return Result::fail (TRANS ("Failed to load!"));
+
+    return read (input);
+}
@@ -0,0 +1,139 @@
+//==============================================================================
+/** An append-only record of the commands given to a GameProcessor,
+    along with the random seed it was started with, the tick at which
+    each command was accepted and the last tick the session got to,
+    so that a session can be replayed exactly.
+
+    Commands are kept back to back in a single block of text, so appending
+    one doesn't allocate once the journal has grown to its working size.
+    A journal can also stream each entry to an output stream (eg: a file)
+    as it's appended, so that a crashing session leaves its journal behind.
+
+    The layout of a written journal is as follows:
+    @code
+        "DkJn"          4 byte magic
+        version         uint16, little-endian
+        seed            int64, little-endian
+        entries         until the end of the stream, each as a tick (int64, little-endian),
+                        a compressed int length (see OutputStream::writeCompressedInt),
+                        and that many bytes of UTF-8, or a length of -1 and no bytes
+                        for a tick that was got to after the last command (since version 2)
+    @endcode
+
+    @see GameProcessor::startRecording, GameProcessor::replay
+*/
+class CommandJournal final
+{
+public:
+    /** */
+    explicit CommandJournal (int64 seedToUse = 0) noexcept :
+        seed (seedToUse)
+    {
+    }
+
+    /** The version written by this build, and the newest one it can read. */
+    static constexpr int currentVersion = 2;
+
+    //==============================================================================
+    /** @returns the seed that the recorded session's random number generator started with. */
+    [[nodiscard]] int64 getSeed() const noexcept                { return seed; }
+
+    /** @returns the number of recorded commands. */
+    [[nodiscard]] int size() const noexcept                     { return entries.size(); }
+    /** @returns */
+    [[nodiscard]] bool isEmpty() const noexcept                 { return entries.isEmpty(); }
+
+    /** @returns the tick at which the command at the index was accepted. */
+    [[nodiscard]] uint64 getTick (int index) const noexcept     { return entries[index].tick; }
+
+    /** @returns the last tick the recorded session got to, with or without a command. */
+    [[nodiscard]] uint64 getLastTick() const noexcept
+    {
+        return entries.isEmpty() ? lastTick : jmax (lastTick, entries.getLast().tick);
+    }
+
+    /** @returns the command at the index, which stays valid until the journal is next changed. */
+    [[nodiscard]] std::string_view getCommand (int index) const noexcept
+    {
+        if (! isPositiveAndBelow (index, entries.size()))
+            return {};
+
+        const auto& e = entries.getReference (index);
+        return { text.data() + e.offset, e.length };
+    }
+
+    //==============================================================================
+    /** Records a command, writing it to the output stream if there is one.
+        Ticks must never go backwards.
+    */
+    void append (uint64 tick, std::string_view command);
+
+    /** Records that the session got to the tick, so that a replay goes
+        as far even when no command was given since.
+
+        This is only written to the output stream when the journal is flushed,
+        and only if no command was appended at or after the tick, so that
+        idle ticks don't grow the stream: a command's own tick says as much.
+
+        Ticks must never go backwards.
+    */
+    void markTick (uint64 tick);
+
+    /** Removes every command and tick, keeping the seed. */
+    void clear() noexcept
+    {
+        entries.clearQuick();
+        text.clear();
+        lastTick = lastWrittenTick = 0;
+    }
+
+    //==============================================================================
+    /** Writes the header and any commands recorded so far to the stream,
+        then keeps writing each new command to it as it's appended.
+    */
+    void startWritingTo (std::unique_ptr<OutputStream> output);
+
+    /** Flushes and releases the stream being written to, if any. */
+    void stopWriting();
+
+    /** Writes the last tick if it's past the last command, then flushes the stream being written to, if any. */
+    void flush();
+
+    //==============================================================================
+    /** Writes the whole journal to the stream. */
+    void write (OutputStream& output) const;
+
+    /** Writes the whole journal to a temporary file that then replaces the destination. */
+    [[nodiscard]] Result save (const File& destination) const;
+
+    /** Replaces this journal's seed and commands with those read from the stream.
+        A journal cut short in the middle of its last entry, like by a crash,
+        is read up until that entry.
+    */
+    [[nodiscard]] Result read (InputStream& input);
+
+    /** @see read */
+    [[nodiscard]] Result load (const File& source);
+
+private:
+    //==============================================================================
+    struct Entry final
+    {
+        uint64 tick = 0;
+        size_t offset = 0, length = 0;
+    };
+
+    int64 seed = 0;
+    uint64 lastTick = 0, lastWrittenTick = 0;
+    Array<Entry> entries;
+    std::string text;
+    std::unique_ptr<OutputStream> stream;
+
+    //==============================================================================
+    void writeHeader (OutputStream&) const;
+    static void writeEntry (OutputStream&, uint64 tick, std::string_view command);
+    static void writeTick (OutputStream&, uint64 tick);
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CommandJournal)
+};
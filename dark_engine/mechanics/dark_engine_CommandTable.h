@@ -0,0 +1,244 @@
+//==============================================================================
+/** The IDs of the commands that GameProcessor understands out of the box.
+
+    Custom commands can be given any ID from userCommand onwards.
+
+    @see CommandTable, GameProcessor
+*/
+enum class GameCommandIDs
+{
+    help,
+    quit,
+    move,
+    pickUp,
+    talk,
+    push,
+    pull,
+    enter,
+
+    // Cheats:
+    kill,
+    add,
+    remove,
+    set,
+    player,
+    playerGodMode,
+    playerAdd,
+    playerRemove,
+    playerSet,
+
+    userCommand = 0x1000
+};
+
+//==============================================================================
+/** A table of commands, and their aliases, that recognises the first token
+    of a command in constant time.
+
+    Each name is keyed by its case-folded hash (the same one VerbTable uses),
+    so looking up a token neither lower-cases nor copies it, and the cost
+    stays flat however many commands and aliases are registered.
+
+    A command can own a table of sub-commands (eg: "player set"),
+    which is searched with the token that follows.
+
+    @see CommandTokenizer, GameProcessor, GameCommandIDs
+*/
+class CommandTable final
+{
+public:
+    /** Called with the command's tokens and the index of its first argument.
+        The argument index is one past the token that named the command.
+    */
+    using Handler = std::function<Result (const CommandTokenizer& tokens, int firstArgumentIndex)>;
+
+    /** */
+    struct Command final
+    {
+        /** @returns the sub-commands, creating them if need be. */
+        CommandTable& getSubcommands()
+        {
+            if (subcommands == nullptr)
+                subcommands = std::make_unique<CommandTable>();
+
+            return *subcommands;
+        }
+
+        std::string name;
+        int id = 0;
+        Handler handler;
+        std::unique_ptr<CommandTable> subcommands;
+
+        /** The other names that find this command. Each is allocated on its own,
+            so that the table's views of them stay put as aliases come and go.
+        */
+        std::vector<std::unique_ptr<std::string>> aliases;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Command)
+    };
+
+    //==============================================================================
+    /** */
+    CommandTable() = default;
+
+    //==============================================================================
+    /** Registers a command, replacing any command or alias with the same name.
+        The name must be lower-case.
+
+        @returns the new command, so that sub-commands can be added to it.
+    */
+    Command& add (std::string_view name, int commandId, Handler handler = nullptr)
+    {
+        jassert (isLowerCase (name));
+
+        remove (name);
+
+        auto* command = commands.add (new Command());
+        command->name = std::string (name);
+        command->id = commandId;
+        command->handler = std::move (handler);
+
+        lookup[VerbHashing::hash (name)].add (Entry { command->name, command });
+        return *command;
+    }
+
+    /** @see add */
+    Command& add (std::string_view name, GameCommandIDs commandId, Handler handler = nullptr)
+    {
+        return add (name, static_cast<int> (commandId), std::move (handler));
+    }
+
+    /** Makes another name find an existing command.
+        The alias must be lower-case, and will replace any command or alias with the same name.
+
+        @returns false if there's no command with the existing name.
+    */
+    bool addAlias (std::string_view alias, std::string_view existingName)
+    {
+        jassert (isLowerCase (alias));
+
+        // Removed first, in case the alias replaces the command it was going to find:
+        remove (alias);
+
+        auto* command = find (existingName);
+        if (command == nullptr)
+            return false;
+
+        const auto& name = *command->aliases.emplace_back (std::make_unique<std::string> (alias));
+        lookup[VerbHashing::hash (alias)].add (Entry { name, command });
+        return true;
+    }
+
+    /** Removes the command or alias with the name, if there is one.
+        Removing a command removes its aliases too, freeing their names.
+    */
+    void remove (std::string_view name)
+    {
+        const auto bucket = lookup.find (VerbHashing::hash (name));
+        if (bucket == lookup.end())
+            return;
+
+        auto& entries = bucket->second;
+
+        for (int i = 0; i < entries.size(); ++i)
+        {
+            const auto entry = entries.getReference (i);
+
+            if (entry.name == name)
+            {
+                entries.remove (i);
+
+                if (entry.command->name == name)
+                {
+                    for (auto& [hash, others] : lookup)
+                        others.removeIf ([&] (const Entry& e) { return e.command == entry.command; });
+
+                    commands.removeObject (entry.command);
+                }
+                else
+                {
+                    auto& names = entry.command->aliases;
+                    const auto alias = std::find_if (names.begin(), names.end(),
+                                                     [&] (const auto& n) { return n->data() == entry.name.data(); });
+
+                    if (alias != names.end())
+                        names.erase (alias);
+                }
+
+                return;
+            }
+        }
+    }
+
+    //==============================================================================
+    /** @returns the command or alias matching the token, ignoring the token's case, or nullptr. */
+    [[nodiscard]] Command* find (std::string_view token) const noexcept
+    {
+        if (const auto bucket = lookup.find (VerbHashing::hash (token)); bucket != lookup.end())
+            for (const auto& entry : bucket->second)
+                if (VerbHashing::equalsIgnoringCase (entry.name, token))
+                    return entry.command;
+
+        return nullptr;
+    }
+
+    /** @returns the number of commands, not counting aliases. */
+    [[nodiscard]] int getNumCommands() const noexcept   { return commands.size(); }
+
+    /** @returns */
+    [[nodiscard]] Command* getCommand (int index) const noexcept { return commands[index]; }
+
+    //==============================================================================
+    /** Finds the command named by the token at the index, descending into its
+        sub-commands for as long as the following tokens name one, then calls
+        the deepest command's handler.
+
+        If a sub-command is named but has no handler, its parent's handler is used.
+
+        @returns the handler's result, or nothing if the token doesn't name a command.
+    */
+    [[nodiscard]] std::optional<Result> dispatch (const CommandTokenizer& tokens, int index = 0) const
+    {
+        auto* command = find (tokens[index]);
+        if (command == nullptr)
+            return {};
+
+        if (command->subcommands != nullptr)
+            if (auto r = command->subcommands->dispatch (tokens, index + 1); r.has_value())
+                return r;
+
+        if (command->handler != nullptr)
+            return command->handler (tokens, index + 1);
+
+        return Result::fail (TRANS ("You'll have to be more specific..."));
+    }
+
+private:
+    //==============================================================================
+    struct Entry final
+    {
+        std::string_view name;
+        Command* command = nullptr;
+    };
+
+    /** The keys are already hashes, so are used as they are. */
+    struct IdentityHash final
+    {
+        size_t operator() (uint32 h) const noexcept { return h; }
+    };
+
+    OwnedArray<Command> commands;
+    std::unordered_map<uint32, Array<Entry>, IdentityHash> lookup;
+
+    //==============================================================================
+    [[nodiscard]] static bool isLowerCase (std::string_view name) noexcept
+    {
+        for (const auto c : name)
+            if (VerbHashing::toLower (c) != c)
+                return false;
+
+        return ! name.empty();
+    }
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CommandTable)
+};
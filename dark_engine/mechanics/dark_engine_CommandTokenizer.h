@@ -0,0 +1,154 @@
+//==============================================================================
+/** Splits a command typed by the player into tokens without allocating.
+
+    The message is copied into a fixed buffer owned by the tokenizer, and
+    each token is a view into that buffer, so a tokenizer can be reused for
+    every command without touching the heap.
+
+    Tokens are separated by whitespace. Text within single or double quotes
+    is kept as a single token, without its quotes.
+
+    Case isn't changed: it's folded while comparing instead,
+    so no lower-cased copy of the message is ever made.
+
+    @see GameProcessor, VerbTable
+*/
+class CommandTokenizer final
+{
+public:
+    /** */
+    CommandTokenizer() = default;
+
+    //==============================================================================
+    /** The most bytes of UTF-8 that a message can hold. */
+    static constexpr size_t maxMessageLength = 512;
+    /** The most tokens that a message can be split into. */
+    static constexpr int maxTokens = 32;
+
+    //==============================================================================
+    /** Splits the message into tokens, replacing any previous ones.
+
+        @returns false if the message was too long or had too many tokens,
+                 in which case there will be no tokens.
+    */
+    bool tokenize (std::string_view message) noexcept
+    {
+        numTokens = 0;
+
+        if (message.size() > maxMessageLength)
+            return false;
+
+        std::copy (message.begin(), message.end(), buffer.begin());
+
+        const auto* pos = buffer.data();
+        const auto* const end = pos + message.size();
+
+        for (;;)
+        {
+            while (pos < end && isWhitespace (*pos))
+                ++pos;
+
+            if (pos >= end)
+                return true;
+
+            const auto* tokenStart = pos;
+            const auto* tokenEnd = pos;
+
+            if (*pos == '"' || *pos == '\'')
+            {
+                const auto quote = *pos++;
+                tokenStart = pos;
+
+                while (pos < end && *pos != quote)
+                    ++pos;
+
+                tokenEnd = pos;
+
+                if (pos < end)
+                    ++pos; // Skip the closing quote.
+            }
+            else
+            {
+                while (pos < end && ! isWhitespace (*pos))
+                    ++pos;
+
+                tokenEnd = pos;
+            }
+
+            if (tokenEnd == tokenStart)
+                continue; // Empty quotes.
+
+            if (numTokens >= maxTokens)
+            {
+                numTokens = 0;
+                return false;
+            }
+
+            tokens[(size_t) numTokens++] = { tokenStart, static_cast<size_t> (tokenEnd - tokenStart) };
+        }
+    }
+
+    /** Splits the message into tokens, replacing any previous ones.
+        @see tokenize
+    */
+    bool tokenize (const String& message) noexcept
+    {
+        return tokenize (std::string_view (message.toRawUTF8(), message.getNumBytesAsUTF8()));
+    }
+
+    //==============================================================================
+    /** @returns the number of tokens. */
+    [[nodiscard]] int size() const noexcept                     { return numTokens; }
+    /** @returns true if there are no tokens. */
+    [[nodiscard]] bool isEmpty() const noexcept                 { return numTokens == 0; }
+
+    /** @returns the token at the index, or an empty view if the index is out of range.
+        The view stays valid until the next call to tokenize().
+    */
+    [[nodiscard]] std::string_view operator[] (int index) const noexcept
+    {
+        return isPositiveAndBelow (index, numTokens) ? tokens[(size_t) index] : std::string_view();
+    }
+
+    /** @returns the tokens from the index onwards, like the arguments that follow a command. */
+    [[nodiscard]] std::span<const std::string_view> getTokens (int firstIndex = 0) const noexcept
+    {
+        const auto first = (size_t) jlimit (0, numTokens, firstIndex);
+        return { tokens.data() + first, (size_t) numTokens - first };
+    }
+
+    /** @returns */
+    [[nodiscard]] const std::string_view* begin() const noexcept    { return tokens.data(); }
+    /** @returns */
+    [[nodiscard]] const std::string_view* end() const noexcept      { return tokens.data() + numTokens; }
+
+    //==============================================================================
+    /** @returns true if the token at the index matches the lower-case word, ignoring the token's case. */
+    [[nodiscard]] bool matches (int index, std::string_view lowerCaseWord) const noexcept
+    {
+        return isPositiveAndBelow (index, numTokens)
+            && VerbHashing::equalsIgnoringCase (lowerCaseWord, tokens[(size_t) index]);
+    }
+
+    /** @returns the token at the index as a String, for the rare places that need to keep it. */
+    [[nodiscard]] String getString (int index) const
+    {
+        const auto token = operator[] (index);
+        return String::fromUTF8 (token.data(), (int) token.size());
+    }
+
+private:
+    //==============================================================================
+    std::array<char, maxMessageLength> buffer;
+    std::array<std::string_view, maxTokens> tokens;
+    int numTokens = 0;
+
+    //==============================================================================
+    [[nodiscard]] static constexpr bool isWhitespace (char c) noexcept
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CommandTokenizer)
+};
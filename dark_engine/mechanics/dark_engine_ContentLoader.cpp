@@ -0,0 +1,858 @@
+namespace
+{
+    /** Guards against malformed documents growing the container stack without bounds. */
+    constexpr size_t maxJSONDepth = 512;
+
+    //==============================================================================
+    struct JSONEventReader final
+    {
+        JSONEventReader (const void* data, size_t numBytes, JSONEventParser::Handler& h) noexcept :
+            start (static_cast<const char*> (data)),
+            pos (start),
+            end (start + numBytes),
+            handler (h)
+        {
+        }
+
+        Result run()
+        {
+            // Skip any UTF-8 BOM:
+            if (end - pos >= 3 && (uint8) pos[0] == 0xef && (uint8) pos[1] == 0xbb && (uint8) pos[2] == 0xbf)
+                pos += 3;
+
+            skipWhitespace();
+
+            if (pos >= end)
+                return Result::ok();
+
+            for (;;)
+            {
+                if (! readValue())
+                    return fail (error);
+
+                // Close every container that ends here, then move on to the next value:
+                for (;;)
+                {
+                    skipWhitespace();
+
+                    if (containers.empty())
+                    {
+                        if (pos < end)
+                            return fail (TRANS ("Unexpected text after the end of the document"));
+
+                        return Result::ok();
+                    }
+
+                    if (pos >= end)
+                        return fail (TRANS ("Unexpected end of the document"));
+
+                    const auto c = *pos++;
+                    const auto container = containers.back();
+
+                    if (c == ',')
+                    {
+                        if (container == '{' && ! readKey())
+                            return fail (error);
+
+                        break;
+                    }
+
+                    if (c != (container == '{' ? '}' : ']'))
+                        return fail (TRANS ("Expected a comma or the end of the container"));
+
+                    containers.pop_back();
+
+                    if (container == '{')
+                        handler.endObject();
+                    else
+                        handler.endArray();
+                }
+            }
+        }
+
+    private:
+        const char* const start;
+        const char* pos;
+        const char* const end;
+        JSONEventParser::Handler& handler;
+        std::vector<char> containers;
+        std::string scratch;
+        String error;
+
+        //==============================================================================
+        Result fail (const String& message) const
+        {
+            return Result::fail (message + " (" + TRANS ("at byte") + " " + String ((int64) (pos - start)) + ")");
+        }
+
+        bool setError (const String& message)
+        {
+            error = message;
+            return false;
+        }
+
+        void skipWhitespace() noexcept
+        {
+            while (pos < end && (*pos == ' ' || *pos == '\n' || *pos == '\r' || *pos == '\t'))
+                ++pos;
+        }
+
+        bool expect (char c)
+        {
+            skipWhitespace();
+
+            if (pos < end && *pos == c)
+            {
+                ++pos;
+                return true;
+            }
+
+            return setError (TRANS ("Expected") + " '" + String::charToString ((juce_wchar) c) + "'");
+        }
+
+        bool matchLiteral (const char* literal, size_t length) noexcept
+        {
+            if (static_cast<size_t> (end - pos) < length || std::memcmp (pos, literal, length) != 0)
+                return false;
+
+            pos += length;
+            return true;
+        }
+
+        //==============================================================================
+        /** Reads a value, reporting a scalar directly or opening a container.
+            Empty containers are opened and closed straight away.
+        */
+        bool readValue()
+        {
+            skipWhitespace();
+
+            if (pos >= end)
+                return setError (TRANS ("Unexpected end of the document"));
+
+            switch (*pos)
+            {
+                case '{':
+                case '[':
+                {
+                    const auto container = *pos++;
+
+                    if (containers.size() >= maxJSONDepth)
+                        return setError (TRANS ("The document is nested too deeply"));
+
+                    if (container == '{')
+                        handler.startObject();
+                    else
+                        handler.startArray();
+
+                    skipWhitespace();
+
+                    const auto closer = container == '{' ? '}' : ']';
+
+                    if (pos < end && *pos == closer)
+                    {
+                        ++pos;
+
+                        if (container == '{')
+                            handler.endObject();
+                        else
+                            handler.endArray();
+
+                        return true;
+                    }
+
+                    containers.push_back (container);
+                    return container == '{' ? readKey() && readValue()
+                                            : readValue();
+                }
+
+                case '"':
+                {
+                    std::string_view text;
+                    if (! readString (text))
+                        return false;
+
+                    handler.value (String::fromUTF8 (text.data(), (int) text.size()));
+                    return true;
+                }
+
+                case 't':
+                    if (! matchLiteral ("true", 4))
+                        return setError (TRANS ("Unexpected character"));
+
+                    handler.value (true);
+                    return true;
+
+                case 'f':
+                    if (! matchLiteral ("false", 5))
+                        return setError (TRANS ("Unexpected character"));
+
+                    handler.value (false);
+                    return true;
+
+                case 'n':
+                    if (! matchLiteral ("null", 4))
+                        return setError (TRANS ("Unexpected character"));
+
+                    handler.value (var());
+                    return true;
+
+                default:
+                    return readNumber();
+            }
+        }
+
+        /** Reads a key and its colon. */
+        bool readKey()
+        {
+            skipWhitespace();
+
+            if (pos >= end || *pos != '"')
+                return setError (TRANS ("Expected a key"));
+
+            std::string_view text;
+            if (! readString (text))
+                return false;
+
+            handler.key (text);
+            return expect (':');
+        }
+
+        /** Reads a string, pointing straight into the source unless it has escape sequences. */
+        bool readString (std::string_view& result)
+        {
+            ++pos; // Opening quote
+
+            const auto* const first = pos;
+
+            while (pos < end && *pos != '"' && *pos != '\\')
+            {
+                if ((uint8) *pos < 0x20)
+                    return setError (TRANS ("Unexpected control character in a string"));
+
+                ++pos;
+            }
+
+            if (pos >= end)
+                return setError (TRANS ("Unterminated string"));
+
+            if (*pos == '"')
+            {
+                result = { first, static_cast<size_t> (pos++ - first) };
+                return true;
+            }
+
+            scratch.assign (first, static_cast<size_t> (pos - first));
+
+            while (pos < end && *pos != '"')
+            {
+                const auto c = *pos++;
+
+                if ((uint8) c < 0x20)
+                    return setError (TRANS ("Unexpected control character in a string"));
+
+                if (c != '\\')
+                {
+                    scratch += c;
+                    continue;
+                }
+
+                if (pos >= end)
+                    break;
+
+                switch (*pos++)
+                {
+                    case '"':   scratch += '"'; break;
+                    case '\\':  scratch += '\\'; break;
+                    case '/':   scratch += '/'; break;
+                    case 'b':   scratch += '\b'; break;
+                    case 'f':   scratch += '\f'; break;
+                    case 'n':   scratch += '\n'; break;
+                    case 'r':   scratch += '\r'; break;
+                    case 't':   scratch += '\t'; break;
+
+                    case 'u':
+                    {
+                        uint32 codePoint = 0;
+                        if (! readHex4 (codePoint))
+                            return false;
+
+                        // Combine a UTF-16 surrogate pair:
+                        if (codePoint >= 0xd800 && codePoint < 0xdc00
+                            && end - pos >= 6 && pos[0] == '\\' && pos[1] == 'u')
+                        {
+                            pos += 2;
+
+                            uint32 low = 0;
+                            if (! readHex4 (low))
+                                return false;
+
+                            if (low >= 0xdc00 && low < 0xe000)
+                                codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (low - 0xdc00);
+                        }
+
+                        appendUTF8 (codePoint);
+                        break;
+                    }
+
+                    default:
+                        return setError (TRANS ("Invalid escape sequence"));
+                }
+            }
+
+            if (pos >= end)
+                return setError (TRANS ("Unterminated string"));
+
+            ++pos; // Closing quote
+            result = scratch;
+            return true;
+        }
+
+        bool readHex4 (uint32& result)
+        {
+            if (end - pos < 4)
+                return setError (TRANS ("Invalid escape sequence"));
+
+            for (int i = 0; i < 4; ++i)
+            {
+                const auto digit = CharacterFunctions::getHexDigitValue ((juce_wchar) (uint8) *pos++);
+
+                if (digit < 0)
+                    return setError (TRANS ("Invalid escape sequence"));
+
+                result = (result << 4) | (uint32) digit;
+            }
+
+            return true;
+        }
+
+        void appendUTF8 (uint32 c)
+        {
+            if (c < 0x80)
+            {
+                scratch += (char) c;
+            }
+            else if (c < 0x800)
+            {
+                scratch += (char) (0xc0 | (c >> 6));
+                scratch += (char) (0x80 | (c & 0x3f));
+            }
+            else if (c < 0x10000)
+            {
+                scratch += (char) (0xe0 | (c >> 12));
+                scratch += (char) (0x80 | ((c >> 6) & 0x3f));
+                scratch += (char) (0x80 | (c & 0x3f));
+            }
+            else
+            {
+                scratch += (char) (0xf0 | (c >> 18));
+                scratch += (char) (0x80 | ((c >> 12) & 0x3f));
+                scratch += (char) (0x80 | ((c >> 6) & 0x3f));
+                scratch += (char) (0x80 | (c & 0x3f));
+            }
+        }
+
+        /** Integers that fit are reported as an int or int64, and anything else as a double. */
+        bool readNumber()
+        {
+            const auto* const first = pos;
+            auto isInteger = true;
+
+            if (pos < end && *pos == '-')
+                ++pos;
+
+            if (pos >= end || ! CharacterFunctions::isDigit (*pos))
+                return setError (TRANS ("Unexpected character"));
+
+            while (pos < end)
+            {
+                const auto c = *pos;
+
+                if (c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-')
+                    isInteger = false;
+                else if (! CharacterFunctions::isDigit (c))
+                    break;
+
+                ++pos;
+            }
+
+            const auto length = static_cast<size_t> (pos - first);
+
+            if (isInteger)
+            {
+                const auto negative = *first == '-';
+                uint64 magnitude = 0;
+                auto overflowed = false;
+
+                for (const auto* p = first + (negative ? 1 : 0); p < pos; ++p)
+                {
+                    const auto digit = static_cast<uint64> (*p - '0');
+
+                    if (magnitude > (std::numeric_limits<uint64>::max() - digit) / 10)
+                    {
+                        overflowed = true;
+                        break;
+                    }
+
+                    magnitude = magnitude * 10 + digit;
+                }
+
+                constexpr auto maxInt64 = static_cast<uint64> (std::numeric_limits<int64>::max());
+
+                if (! overflowed && magnitude <= maxInt64)
+                {
+                    const auto v = negative ? -static_cast<int64> (magnitude) : static_cast<int64> (magnitude);
+
+                    if (v >= std::numeric_limits<int>::min() && v <= std::numeric_limits<int>::max())
+                        handler.value (static_cast<int> (v));
+                    else
+                        handler.value (v);
+
+                    return true;
+                }
+            }
+
+            char buffer[64];
+            if (length >= sizeof (buffer))
+                return setError (TRANS ("Number too long"));
+
+            std::memcpy (buffer, first, length);
+            buffer[length] = 0;
+
+            auto text = CharPointer_ASCII (buffer);
+            handler.value (CharacterFunctions::readDoubleValue (text));
+            return true;
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (JSONEventReader)
+    };
+
+    //==============================================================================
+    /** The properties that the engine reads as a String, like WorldEntity's subtype. */
+    const Identifier* const textProperties[] =
+    {
+        &nameId, &descriptionId, &subtypeId, &interactionIdId,
+        &mapIconId, &screenIconId, &inventoryIconId
+    };
+
+    bool isTextProperty (const Identifier& id) noexcept
+    {
+        for (const auto* textProperty : textProperties)
+            if (*textProperty == id)
+                return true;
+
+        return false;
+    }
+
+    /** @returns the values joined by spaces, or a void var if any isn't a scalar. */
+    var joinScalars (const Array<var>& values)
+    {
+        StringArray words;
+
+        for (const auto& v : values)
+        {
+            if (v.isArray() || v.isObject())
+                return {};
+
+            words.add (v.toString());
+        }
+
+        return words.joinIntoString (" ");
+    }
+}
+
+//==============================================================================
+Result JSONEventParser::parse (const void* data, size_t numBytes, Handler& handler)
+{
+    if (data == nullptr || numBytes == 0)
+        return Result::ok();
+
+    return JSONEventReader (data, numBytes, handler).run();
+}
+
+//==============================================================================
+struct WorldEntityDefinitionParser::Frame final
+{
+    enum class Kind
+    {
+        definitions,    // The document's outermost container.
+        object,         // A definition, or an object within one.
+        localised,      // An object of translations, of which only one is kept.
+        array,
+        ignored         // Anything nested where it has no meaning.
+    };
+
+    Kind kind = Kind::ignored;
+    Identifier key;             // The key the container was found under.
+    Identifier currentKey;      // The key of the value about to be read, for objects.
+    ValueTree tree;             // The tree being filled, for objects, or the tree holding the array.
+    bool mergedIntoParent = false;
+    Identifier retype;
+    Array<var> values;
+    String translation, fallbackTranslation;
+};
+
+WorldEntityDefinitionParser::WorldEntityDefinitionParser (const Identifier& categoryId,
+                                                          const Identifier& defaultElementTypeToUse,
+                                                          const String& languageToUse) :
+    definitions (categoryId),
+    defaultElementType (defaultElementTypeToUse),
+    language (languageToUse)
+{
+    frames.reserve (16);
+}
+
+WorldEntityDefinitionParser::~WorldEntityDefinitionParser() = default;
+
+Result WorldEntityDefinitionParser::parse (const File& source)
+{
+    if (source.getSize() == 0)
+        return Result::ok();
+
+    const MemoryMappedFile mappedFile (source, MemoryMappedFile::readOnly);
+
+    if (mappedFile.getData() == nullptr)
+        return Result::fail (TRANS ("Failed to load!") + " " + source.getFileName());
+
+    const auto result = parse (mappedFile.getData(), mappedFile.getSize());
+
+    if (result.failed())
+        return Result::fail (source.getFileName() + ": " + result.getErrorMessage());
+
+    return result;
+}
+
+Result WorldEntityDefinitionParser::parse (const void* data, size_t numBytes)
+{
+    frames.clear();
+    return JSONEventParser::parse (data, numBytes, *this);
+}
+
+//==============================================================================
+void WorldEntityDefinitionParser::startObject()
+{
+    if (frames.empty())
+    {
+        frames.push_back ({ Frame::Kind::definitions });
+        return;
+    }
+
+    const auto& parent = frames.back();
+    Frame frame;
+
+    switch (parent.kind)
+    {
+        case Frame::Kind::definitions:
+            frame.kind = Frame::Kind::object;
+            frame.tree = ValueTree (defaultElementType);
+        break;
+
+        case Frame::Kind::object:
+        {
+            frame.key = parent.currentKey;
+
+            if (frame.key == nameId || frame.key == descriptionId)
+            {
+                frame.kind = Frame::Kind::localised;
+            }
+            else if (frame.key.toString() == "base")
+            {
+                frame.kind = Frame::Kind::object;
+                frame.tree = parent.tree;
+                frame.mergedIntoParent = true;
+            }
+            else if (frame.key.isValid())
+            {
+                frame.kind = Frame::Kind::object;
+                frame.tree = ValueTree (frame.key);
+            }
+        }
+        break;
+
+        case Frame::Kind::array:
+            // Objects within an array become children of the tree holding the array:
+            if (parent.tree.isValid())
+            {
+                frame.kind = Frame::Kind::object;
+                frame.key = parent.key;
+                frame.tree = ValueTree (parent.key);
+            }
+        break;
+
+        default:
+        break;
+    }
+
+    frames.push_back (std::move (frame));
+}
+
+void WorldEntityDefinitionParser::endObject()
+{
+    jassert (! frames.empty());
+
+    auto frame = std::move (frames.back());
+    frames.pop_back();
+
+    if (frames.empty())
+        return;
+
+    auto& parent = frames.back();
+
+    if (frame.kind == Frame::Kind::object && ! frame.mergedIntoParent)
+    {
+        if (frame.retype.isValid() && frame.retype != frame.tree.getType())
+        {
+            ValueTree retyped (frame.retype);
+            retyped.copyPropertiesFrom (frame.tree, nullptr);
+
+            while (frame.tree.getNumChildren() > 0)
+            {
+                auto child = frame.tree.getChild (0);
+                frame.tree.removeChild (0, nullptr);
+                retyped.appendChild (child, nullptr);
+            }
+
+            frame.tree = retyped;
+        }
+
+        if (parent.kind == Frame::Kind::definitions)
+            definitions.appendChild (frame.tree, nullptr);
+        else if (parent.tree.isValid())
+            parent.tree.appendChild (frame.tree, nullptr);
+    }
+    else if (frame.kind == Frame::Kind::localised && parent.kind == Frame::Kind::object)
+    {
+        const auto& text = frame.translation.isNotEmpty() ? frame.translation : frame.fallbackTranslation;
+
+        if (text.isNotEmpty())
+            parent.tree.setProperty (frame.key, text, nullptr);
+
+        // What the objects made from a definition refer to it by, which mustn't change with the language:
+        const auto isDefinition = frames.size() >= 2 && frames[frames.size() - 2].kind == Frame::Kind::definitions;
+        const auto& key = frame.fallbackTranslation.isNotEmpty() ? frame.fallbackTranslation : frame.translation;
+
+        if (frame.key == nameId && isDefinition && key.isNotEmpty())
+            parent.tree.setProperty (definitionKeyId, key, nullptr);
+    }
+}
+
+void WorldEntityDefinitionParser::startArray()
+{
+    if (frames.empty())
+    {
+        frames.push_back ({ Frame::Kind::definitions });
+        return;
+    }
+
+    const auto& parent = frames.back();
+    Frame frame;
+
+    if (parent.kind == Frame::Kind::object && parent.currentKey.isValid())
+    {
+        frame.kind = Frame::Kind::array;
+        frame.key = parent.currentKey;
+        frame.tree = parent.tree;
+    }
+    else if (parent.kind == Frame::Kind::array)
+    {
+        frame.kind = Frame::Kind::array;
+        frame.key = parent.key;
+        frame.tree = parent.tree;
+    }
+
+    frames.push_back (std::move (frame));
+}
+
+void WorldEntityDefinitionParser::endArray()
+{
+    jassert (! frames.empty());
+
+    auto frame = std::move (frames.back());
+    frames.pop_back();
+
+    if (frames.empty() || frame.kind != Frame::Kind::array)
+        return;
+
+    auto& parent = frames.back();
+
+    if (parent.kind == Frame::Kind::array)
+    {
+        parent.values.add (std::move (frame.values));
+    }
+    else if (parent.kind == Frame::Kind::object && ! frame.values.isEmpty())
+    {
+        // Something like "subtype": ["Grass", "Poison"] is read by the engine as a single String:
+        auto joined = isTextProperty (frame.key) ? joinScalars (frame.values) : var();
+
+        if (joined.isVoid())
+            parent.tree.setProperty (frame.key, std::move (frame.values), nullptr);
+        else
+            parent.tree.setProperty (frame.key, std::move (joined), nullptr);
+    }
+}
+
+void WorldEntityDefinitionParser::key (std::string_view text)
+{
+    auto& frame = frames.back();
+
+    if (frame.kind != Frame::Kind::object && frame.kind != Frame::Kind::localised)
+        return;
+
+    frame.currentKey = text.empty() ? Identifier()
+                                    : Identifier (String::CharPointerType (text.data()),
+                                                  String::CharPointerType (text.data() + text.size()));
+}
+
+void WorldEntityDefinitionParser::value (const var& v)
+{
+    if (frames.empty())
+        return;
+
+    auto& frame = frames.back();
+
+    switch (frame.kind)
+    {
+        case Frame::Kind::object:
+            if (! frame.currentKey.isValid() || v.isVoid())
+                break;
+
+            if (frame.currentKey == typeId && v.isString() && ! frame.mergedIntoParent)
+                frame.retype = v.toString();
+            else
+                frame.tree.setProperty (frame.currentKey, v, nullptr);
+        break;
+
+        case Frame::Kind::localised:
+            if (frame.currentKey.toString() == language)
+                frame.translation = v.toString();
+            else if (frame.currentKey.toString() == "english")
+                frame.fallbackTranslation = v.toString();
+        break;
+
+        case Frame::Kind::array:
+            frame.values.add (v);
+        break;
+
+        default:
+        break;
+    }
+}
+
+//==============================================================================
+ContentLoader::ContentLoader (int numThreads) :
+    pool (new ThreadPool (jmax (1, numThreads)), true)
+{
+}
+
+ContentLoader::ContentLoader (ThreadPool& sharedPool) :
+    pool (&sharedPool, false)
+{
+}
+
+Result ContentLoader::load (const File& contentFolder, GameMap& gameMap)
+{
+    struct Category final
+    {
+        Identifier id;
+        const char* elementType;
+    };
+
+    const Category categories[] =
+    {
+        { enemiesId,            "enemy" },
+        { weaponsId,            "weapon" },
+        { npcsId,               "npc" },
+        { movesId,              "move" },
+        { inanimateObjectsId,   "inanimateObject" }
+    };
+
+    struct ParseJob final : public ThreadPoolJob
+    {
+        ParseJob (const File& f, const Category& category) :
+            ThreadPoolJob ("Parse " + f.getFileName()),
+            file (f),
+            parser (category.id, category.elementType)
+        {
+        }
+
+        JobStatus runJob() override
+        {
+            result = parser.parse (file);
+            return jobHasFinished;
+        }
+
+        const File file;
+        WorldEntityDefinitionParser parser;
+        Result result = Result::ok();
+    };
+
+    OwnedArray<ParseJob> jobs;
+
+    for (const auto& category : categories)
+    {
+        const auto file = contentFolder.getChildFile (category.id.toString() + ".json");
+
+        if (file.existsAsFile())
+        {
+            auto* job = jobs.add (new ParseJob (file, category));
+            pool->addJob (job, false);
+        }
+    }
+
+    auto result = Result::ok();
+    auto definitions = gameMap.getDefinitionsState();
+
+    for (auto* job : jobs)
+    {
+        pool->waitForJobToFinish (job, -1);
+
+        if (job->result.failed())
+        {
+            if (result.wasOk())
+                result = job->result;
+
+            continue;
+        }
+
+        auto source = job->parser.getDefinitions();
+        auto target = definitions.getOrCreateChildWithName (source.getType(), nullptr);
+
+        Array<ValueTree> parsed;
+        parsed.ensureStorageAllocated (source.getNumChildren());
+
+        for (const auto& child : source)
+            parsed.add (child);
+
+        source.removeAllChildren (nullptr);
+
+        for (auto& child : parsed)
+            target.appendChild (child, nullptr);
+    }
+
+    return result;
+}
+
+Result ContentLoader::validate (const GameMap& gameMap)
+{
+    StringArray problems;
+
+    for (const auto& category : gameMap.getDefinitionsState())
+    {
+        for (const auto& definition : category)
+        {
+            for (const auto* textProperty : textProperties)
+            {
+                if (const auto* v = definition.getPropertyPointer (*textProperty); v != nullptr && ! v->isString())
+                {
+                    problems.add (category.getType().toString() + "/" + definition[nameId].toString() + ": "
+                                  + textProperty->toString() + " " + TRANS ("isn't text"));
+                }
+            }
+        }
+    }
+
+    if (problems.isEmpty())
+        return Result::ok();
+
+    return Result::fail (problems.joinIntoString ("\n"));
+}
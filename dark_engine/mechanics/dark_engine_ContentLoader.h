@@ -0,0 +1,155 @@
+//==============================================================================
+/** A streaming, SAX-style JSON parser.
+
+    Rather than building a DOM, this reports each object, array, key and value
+    to a Handler as it's found, straight from the source bytes (eg: a
+    memory-mapped file), leaving the handler to only keep what it needs.
+
+    @see WorldEntityDefinitionParser
+*/
+class JSONEventParser final
+{
+public:
+    /** Receives the events of a JSON document, in order. */
+    struct Handler
+    {
+        /** */
+        virtual ~Handler() = default;
+
+        /** */
+        virtual void startObject() = 0;
+        /** */
+        virtual void endObject() = 0;
+        /** */
+        virtual void startArray() = 0;
+        /** */
+        virtual void endArray() = 0;
+
+        /** Called with each key of an object, before its value.
+            The key's UTF-8 text is only valid for the duration of the call.
+        */
+        virtual void key (std::string_view text) = 0;
+
+        /** Called with each scalar: a string, number, boolean or null (as a void var). */
+        virtual void value (const var& v) = 0;
+    };
+
+    //==============================================================================
+    /** Parses a UTF-8 JSON document, reporting its events to the handler.
+        An empty document is valid, and produces no events.
+    */
+    [[nodiscard]] static Result parse (const void* data, size_t numBytes, Handler& handler);
+
+private:
+    //==============================================================================
+    JSONEventParser() = delete;
+};
+
+//==============================================================================
+/** Fills a definitions category, like the tree of GameMap::getEnemiesState(),
+    from a content file such as "enemies.json".
+
+    The file holds an array of definitions, each becoming a child of the category
+    whose type is taken from the definition's "type" (or the default element type).
+    Within a definition:
+    - Scalars and arrays of scalars become properties, and nulls are left out.
+      Arrays of scalars under a property the engine reads as text, like
+      "subtype": ["Grass", "Poison"], are joined by spaces into a single string.
+    - The keys of the "base" object are merged into the definition itself.
+    - Localised objects ("name", "description") become a single string property,
+      in the chosen language or English. A definition's English name also becomes
+      its definitionKey, so that objects made from it refer to it the same way
+      whatever the language (see Prototype::getKey).
+    - Any other object becomes a child tree, named after its key.
+
+    @see ContentLoader, Prototype
+*/
+class WorldEntityDefinitionParser : private JSONEventParser::Handler
+{
+public:
+    /** */
+    WorldEntityDefinitionParser (const Identifier& categoryId,
+                                 const Identifier& defaultElementType,
+                                 const String& languageToUse = "english");
+
+    /** */
+    ~WorldEntityDefinitionParser() override;
+
+    //==============================================================================
+    /** Parses a content file, which is memory-mapped rather than loaded. */
+    [[nodiscard]] Result parse (const File& source);
+
+    /** Parses a content document held in memory. */
+    [[nodiscard]] Result parse (const void* data, size_t numBytes);
+
+    /** @returns the category tree holding the parsed definitions. */
+    [[nodiscard]] ValueTree getDefinitions() const noexcept { return definitions; }
+
+private:
+    //==============================================================================
+    struct Frame;
+
+    ValueTree definitions;
+    const Identifier defaultElementType;
+    const String language;
+    std::vector<Frame> frames;
+
+    //==============================================================================
+    void startObject() override;
+    void endObject() override;
+    void startArray() override;
+    void endArray() override;
+    void key (std::string_view) override;
+    void value (const var&) override;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WorldEntityDefinitionParser)
+};
+
+//==============================================================================
+/** Loads the definitions of a content folder, like "content/TheDarkFable",
+    into a GameMap.
+
+    Each category's file (eg: "enemies.json", "weapons.json") is parsed
+    on a thread of the loader's pool into a detached tree, and the results
+    are then merged into the map's definitions on the calling thread.
+
+    Keep a loader around to load more content, rather than making one each time,
+    since it starts its threads when it's made unless it's given a pool to share.
+
+    @see WorldEntityDefinitionParser, GameMap
+*/
+class ContentLoader final
+{
+public:
+    /** Creates a loader with its own pool of threads. */
+    explicit ContentLoader (int numThreads = SystemStats::getNumCpus());
+
+    /** Creates a loader that parses on a pool shared with other work (eg: a GameProcessor's prefetching),
+        which must outlive the loader.
+    */
+    explicit ContentLoader (ThreadPool& sharedPool);
+
+    //==============================================================================
+    /** Loads every category file found in the folder into the map's definitions.
+        Missing files are skipped.
+
+        @returns the first error encountered, if any;
+                 the categories that parsed fine are loaded regardless.
+    */
+    [[nodiscard]] Result load (const File& contentFolder, GameMap& gameMap);
+
+    /** Checks that the map's definitions can be read by the engine,
+        like that every property it reads as text is a string.
+
+        @returns an error listing every problem found, if any.
+    */
+    [[nodiscard]] static Result validate (const GameMap& gameMap);
+
+private:
+    //==============================================================================
+    OptionalScopedPointer<ThreadPool> pool;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ContentLoader)
+};
@@ -0,0 +1,123 @@
+//==============================================================================
+void DamageBatch::clear() noexcept
+{
+    for (auto* v : { &level, &power, &attack, &defense, &effectiveness, &randomPercent, &hitRoll, &accuracy, &damage })
+        v->clear();
+}
+
+void DamageBatch::ensureStorageAllocated (int numAttacks)
+{
+    for (auto* v : { &level, &power, &attack, &defense, &effectiveness, &randomPercent, &hitRoll, &accuracy, &damage })
+        v->reserve ((size_t) jmax (0, numAttacks));
+}
+
+int DamageBatch::add (const FightableEntityView& attacker, const FightingMoveView& move,
+                      const FightableEntityView& defender, int randomPercentToUse, int hitRollToUse)
+{
+    const auto category = move.getMoveCategory();
+    const auto isSpecial = category == MoveCategory::special;
+    const auto doesDamage = category == MoveCategory::physical || isSpecial;
+
+    const auto attackStat = isSpecial ? Stat::specialAttack : Stat::attack;
+    const auto defenseStat = isSpecial ? Stat::specialDefense : Stat::defense;
+
+    const auto rawAttack = isSpecial ? attacker.getSpecialAttack() : attacker.getAttack();
+    const auto rawDefense = isSpecial ? defender.getSpecialDefense() : defender.getDefense();
+
+    level.push_back (jlimit (1, maxLevel, attacker.getLevel()));
+    power.push_back (doesDamage ? jlimit (0, maxPower, move.getPower()) : 0);
+    attack.push_back (jlimit (1, maxStat, CombatTables::applyNature (rawAttack, attacker.getNature(), attackStat)));
+    defense.push_back (jlimit (1, maxStat, CombatTables::applyNature (rawDefense, defender.getNature(), defenseStat)));
+    effectiveness.push_back (CombatTables::getEffectiveness (move.getMoveType(), defender.getWeakAgainstType()));
+    randomPercent.push_back (jlimit (minRandomPercent, maxRandomPercent, randomPercentToUse));
+    hitRoll.push_back (jlimit (0, 99, hitRollToUse));
+    accuracy.push_back (move.getAccuracy());
+    damage.push_back (0);
+
+    return size() - 1;
+}
+
+int DamageBatch::add (const FightableEntityView& attacker, const FightingMoveView& move,
+                      const FightableEntityView& defender, Random& random)
+{
+    const auto randomPercentToUse = random.nextInt (Range<int> (minRandomPercent, maxRandomPercent + 1));
+    const auto hitRollToUse = random.nextInt (100);
+    return add (attacker, move, defender, randomPercentToUse, hitRollToUse);
+}
+
+//==============================================================================
+void DamageBatch::calculateReference (const DamageBatch& batch, std::vector<int32>& results, size_t start)
+{
+    for (auto i = start; i < batch.level.size(); ++i)
+        results[i] = calculateDamage (batch.level[i], batch.power[i], batch.attack[i], batch.defense[i],
+                                      batch.effectiveness[i], batch.randomPercent[i],
+                                      batch.hitRoll[i], batch.accuracy[i]);
+}
+
+void DamageBatch::calculateReference()
+{
+    calculateReference (*this, damage, 0);
+}
+
+void DamageBatch::calculate()
+{
+    size_t i = 0;
+
+   #if DARK_ENGINE_USE_SSE2
+    // All of the inputs are clamped so that every product up to the type
+    // effectiveness stays below 2^24, which floats hold exactly. Scaling by
+    // the random percentage can go past that, so it's done in doubles.
+    const auto num = level.size();
+
+    const auto two = _mm_set1_ps (2.0f), five = _mm_set1_ps (5.0f), fifty = _mm_set1_ps (50.0f),
+               quarters = _mm_set1_ps ((float) CombatTables::neutral);
+
+    const auto hundred = _mm_set1_pd (100.0);
+    const auto zero = _mm_setzero_si128(), one = _mm_set1_epi32 (1);
+
+    const auto load = [] (const std::vector<int32>& v, size_t index)
+    {
+        return _mm_loadu_si128 (reinterpret_cast<const __m128i*> (v.data() + index));
+    };
+
+    const auto truncate = [] (__m128 v) { return _mm_cvtepi32_ps (_mm_cvttps_epi32 (v)); };
+
+    for (; i + 4 <= num; i += 4)
+    {
+        const auto pw = load (power, i);
+        const auto eff = load (effectiveness, i);
+
+        const auto levelFactor = _mm_add_ps (truncate (_mm_div_ps (_mm_mul_ps (two, _mm_cvtepi32_ps (load (level, i))), five)), two);
+
+        auto amount = _mm_mul_ps (_mm_mul_ps (levelFactor, _mm_cvtepi32_ps (pw)), _mm_cvtepi32_ps (load (attack, i)));
+        amount = truncate (_mm_div_ps (amount, _mm_cvtepi32_ps (load (defense, i))));
+        amount = _mm_add_ps (truncate (_mm_div_ps (amount, fifty)), two);
+        const auto scaled = _mm_cvttps_epi32 (_mm_div_ps (_mm_mul_ps (amount, _mm_cvtepi32_ps (eff)), quarters));
+
+        // Two lanes at a time in doubles, for the low and high halves:
+        const auto percent = load (randomPercent, i);
+        const auto low = _mm_div_pd (_mm_mul_pd (_mm_cvtepi32_pd (scaled), _mm_cvtepi32_pd (percent)), hundred);
+        const auto high = _mm_div_pd (_mm_mul_pd (_mm_cvtepi32_pd (_mm_srli_si128 (scaled, 8)),
+                                                  _mm_cvtepi32_pd (_mm_srli_si128 (percent, 8))), hundred);
+
+        auto result = _mm_unpacklo_epi64 (_mm_cvttpd_epi32 (low), _mm_cvttpd_epi32 (high));
+        const auto positive = _mm_cmpgt_epi32 (result, zero);
+        result = _mm_or_si128 (_mm_and_si128 (positive, result), _mm_andnot_si128 (positive, one));
+
+        const auto hits = _mm_and_si128 (_mm_cmplt_epi32 (load (hitRoll, i), load (accuracy, i)),
+                                         _mm_and_si128 (_mm_cmpgt_epi32 (pw, zero), _mm_cmpgt_epi32 (eff, zero)));
+
+        _mm_storeu_si128 (reinterpret_cast<__m128i*> (damage.data() + i),
+                          _mm_and_si128 (result, hits));
+    }
+   #endif
+
+    // Whatever's left over, or everything without SSE2:
+    calculateReference (*this, damage, i);
+
+   #if JUCE_DEBUG && DARK_ENGINE_USE_SSE2
+    std::vector<int32> expected (damage.size());
+    calculateReference (*this, expected, 0);
+    jassert (expected == damage);
+   #endif
+}
@@ -53,8 +53,8 @@ public:
 
 private:
     //==============================================================================
-    CachedValue<double> windDirection;
-    CachedValue<WeatherType> weatherType;
+    CachedProperty<double> windDirection;
+    CachedProperty<WeatherType> weatherType;
 
     void setupPropAndCache (UndoManager* undoManager)
     {
@@ -68,35 +68,15 @@ private:
 
     @todo Move the Player to where a "starting point" should be upon load.
 
-    @see GameProcessor, Player
+    @see GameProcessor, WorldManager, Player
 */
 class GameMap final : public EngineObject
 {
 public:
-    /** */
-    GameMap (Player& player_, UndoManager* undoManager = nullptr) :
-        EngineObject (gameMapId, undoManager),
-        player (player_)
-    {
-        world.appendChild (player.getState(), undoManager);
-
-        // Test data
-        world.appendChild (FightingMove ("move").getState(), nullptr);
-        world.appendChild (FightableEntity ("enemy", false).getState(), nullptr);
-        world.appendChild (testStairTileBlocked.getState(), undoManager);
-        world.appendChild (testStairTileUp.getState(), undoManager);
-        world.appendChild (testStairTileDown .getState(), undoManager);
-        world.appendChild (testDoorTileUnlocked.getState(), undoManager);
-        world.appendChild (testDoorTileNeedsKey.getState(), undoManager);
-        world.appendChild (testDoorTileNeedsSpell.getState(), undoManager);
-        world.appendChild (testDoorTileImpassable.getState(), undoManager);
-        world.appendChild (testSecretDoorTileUnlocked.getState(), undoManager);
-        world.appendChild (testSecretDoorTileNeedsKey.getState(), undoManager);
-        world.appendChild (testSecretDoorTileNeedsSpell .getState(), undoManager);
-        world.appendChild (testSecretDoorTileImpassable .getState(), undoManager);
-        world.appendChild (testWallTile1.getState(), undoManager);
-        world.appendChild (testWallTile2.getState(), undoManager);
-
+    /** Creates an empty map. */
+    explicit GameMap (UndoManager* undoManager = nullptr) :
+        EngineObject (gameMapId, undoManager)
+    {
         definitions.appendChild (enemies, undoManager);
         definitions.appendChild (weapons, undoManager);
         definitions.appendChild (npcs, undoManager);
@@ -105,8 +85,154 @@ public:
 
         state.appendChild (definitions, undoManager);
         state.appendChild (world, undoManager);
+        state.appendChild (tileGridState, undoManager);
+    }
+
+    /** Creates a map from a previously saved state, tiles and all.
+        Any player saved along with the state is dropped: use attachPlayer() to place one.
+    */
+    GameMap (const ValueTree& existingState, UndoManager* undoManager = nullptr) :
+        EngineObject (existingState, undoManager),
+        world (state.getOrCreateChildWithName (worldId, undoManager)),
+        definitions (state.getOrCreateChildWithName (definitionsId, undoManager)),
+        enemies (definitions.getOrCreateChildWithName (enemiesId, undoManager)),
+        weapons (definitions.getOrCreateChildWithName (weaponsId, undoManager)),
+        npcs (definitions.getOrCreateChildWithName (npcsId, undoManager)),
+        moves (definitions.getOrCreateChildWithName (movesId, undoManager)),
+        inanimateObjects (definitions.getOrCreateChildWithName (inanimateObjectsId, undoManager)),
+        tileGridState (state.getOrCreateChildWithName (tileGridId, undoManager))
+    {
+        jassert (existingState.hasType (gameMapId));
+
+        for (int i = world.getNumChildren(); --i >= 0;)
+            if (world.getChild (i).hasType (playerId))
+                world.removeChild (i, nullptr);
+
+        // The grid restored the plain tiles from its mirror, but the promoted ones live in the world:
+        for (const auto& child : world)
+        {
+            if (child.hasType (tileId))
+            {
+                auto tile = wrapTile (child);
+                const auto position = tile->getPosition();
+
+                if (tileGrid.getPromotedTile (position) != nullptr)
+                {
+                    jassertfalse; // Two tiles in the same place?
+                    continue;
+                }
+
+                ticker.add (tileGrid.promote (position, std::move (tile)));
+            }
+        }
+    }
+
+    /** Creates a map filled with test data, with the player placed on it. */
+    GameMap (Player& playerToAttach, UndoManager* undoManager = nullptr) :
+        GameMap (undoManager)
+    {
+        attachPlayer (playerToAttach, playerToAttach.getPosition());
+        addTestData (undoManager);
+    }
+
+    //==============================================================================
+    /** Adds a set of test objects to the world, and test tiles to the tile grid.
+        The tiles aren't undoable, like any other tile edit.
+    */
+    void addTestData (UndoManager* undoManager = nullptr)
+    {
+        constexpr Point<int> testTilesOrigin { 2, 0 };
+
+        constexpr StairTile::Direction stairDirections[] =
+        {
+            StairTile::Direction::blocked,
+            StairTile::Direction::up,
+            StairTile::Direction::down
+        };
+
+        constexpr std::pair<DoorLockState, bool> doorStates[] =
+        {
+            { DoorLockState::unlocked, false },
+            { DoorLockState::needsKey, false },
+            { DoorLockState::needsSpell, false },
+            { DoorLockState::impassable, false },
+            { DoorLockState::unlocked, true },
+            { DoorLockState::needsKey, true },
+            { DoorLockState::needsSpell, true },
+            { DoorLockState::impassable, true }
+        };
+
+        world.appendChild (FightingMove ("move").getState(), undoManager);
+        world.appendChild (FightableEntity ("enemy", false).getState(), undoManager);
+
+        // The stairs and doors carry unique state, so are promoted, whereas the walls are plain:
+        int x = testTilesOrigin.x;
+
+        for (const auto& direction : stairDirections)
+            promoteTile (std::make_unique<StairTile> (direction), { x++, testTilesOrigin.y });
+
+        x = testTilesOrigin.x;
+
+        for (const auto& [lockState, secret] : doorStates)
+        {
+            auto door = std::make_unique<DoorTile> (lockState, secret);
+
+            // The doors that can be unlocked lock themselves again after a while:
+            if (lockState == DoorLockState::needsKey || lockState == DoorLockState::needsSpell)
+                door->setRelock (lockState, testDoorRelockDelay);
+
+            promoteTile (std::move (door), { x++, testTilesOrigin.y + 2 });
+        }
+
+        setTile (testWallPosition, EngineTile::Type::wall, Material::vinyl, Colours::white);
+        setTile (testWallPosition.translated (1, 0), EngineTile::Type::wall, Material::ooze, Colours::red);
     }
 
+    /** Where addTestData() puts its first wall, straight south of the top-left corner,
+        which hides whatever is right behind it from a player standing in the corner.
+    */
+    static constexpr Point<int> testWallPosition { 0, 4 };
+
+    /** The number of ticks that addTestData()'s lockable doors stay unlocked for. */
+    static constexpr int testDoorRelockDelay = 10;
+
+    //==============================================================================
+    /** Places the player on this map, at the given position.
+        The player mustn't be on any other map.
+
+        This isn't undoable: the map keeps a pointer to the player and registers it
+        with its ticker, which undoing the world's child edit wouldn't follow.
+    */
+    GameMap& attachPlayer (Player& playerToAttach, Point<int> position)
+    {
+        detachPlayer();
+
+        // Detach the player from the other map first!
+        jassert (! playerToAttach.getState().getParent().isValid());
+
+        player = &playerToAttach;
+        player->setPosition (position);
+        world.appendChild (player->getState(), nullptr);
+        ticker.add (*player);
+        return *this;
+    }
+
+    /** Removes the player from this map, if it's on it. This isn't undoable either. */
+    GameMap& detachPlayer()
+    {
+        if (player != nullptr)
+        {
+            ticker.remove (*player);
+            world.removeChild (player->getState(), nullptr);
+            player = nullptr;
+        }
+
+        return *this;
+    }
+
+    /** @returns the player, or nullptr if the player isn't on this map. */
+    [[nodiscard]] Player* getPlayer() const noexcept                    { return player; }
+
     //==============================================================================
     /** @returns */
     [[nodiscard]] ValueTree getWorldState() const noexcept              { return world; }
@@ -124,15 +250,108 @@ public:
     /** @returns */
     [[nodiscard]] ValueTree getInanimateObjectsState() const noexcept   { return inanimateObjects; }
 
+    /** @returns the first definition, from any of the definition categories, with the given key,
+        in constant time. The result will be invalid if there's no such definition.
+        @see Prototype::getKey, DefinitionIndex
+    */
+    [[nodiscard]] ValueTree findDefinition (const String& definitionKey) const
+    {
+        return definitionIndex.find (definitionKey);
+    }
+
+    /** @returns the prototype that a state was made from, going by its prototypeId,
+        which will have an invalid definition if it wasn't made from one of this map's definitions.
+        Use it to wrap a state, like FightableEntity (state, map.findPrototypeOf (state)),
+        so that the object shares the definition's listener with every other one made from it.
+    */
+    [[nodiscard]] Prototype findPrototypeOf (const ValueTree& state) const
+    {
+        if (const auto* key = state.getPropertyPointer (prototypeId))
+            return definitionIndex.findPrototype (key->toString());
+
+        return {};
+    }
+
+    /** Adds an object made from the definition with the key to the world, at the position,
+        which only stores the properties that later differ from the definition's.
+
+        The map keeps a live object for it, registered with the ticker (see LiveObjects),
+        for as long as it's in the world.
+
+        @returns the object's state, which will be invalid if there's no such definition.
+    */
+    ValueTree spawn (const String& definitionKey, Point<int> position, UndoManager* undoManager = nullptr)
+    {
+        const auto prototype = definitionIndex.findPrototype (definitionKey);
+
+        if (! prototype.definition.isValid())
+        {
+            jassertfalse;
+            return {};
+        }
+
+        WorldObject object (prototype, undoManager);
+        object.setPosition (position, undoManager);
+        world.appendChild (object.getState(), undoManager);
+        return object.getState();
+    }
+
+    /** @returns the index used to find the world's objects by position. */
+    [[nodiscard]] const SpatialIndex& getSpatialIndex() const noexcept  { return spatialIndex; }
+    /** @returns the index of the world's objects that have a StatusCondition. */
+    [[nodiscard]] const StatusIndex& getStatusIndex() const noexcept    { return statusIndex; }
+    /** @returns the index used to find the world's objects by the words the player uses for them. */
+    [[nodiscard]] const NameIndex& getNameIndex() const noexcept        { return nameIndex; }
+
+    /** @returns the ticker that updates the player, the promoted tiles, the objects
+        made from definitions and any other objects registered with it,
+        when they change or their timers are due.
+    */
+    [[nodiscard]] WorldTicker& getTicker() noexcept                     { return ticker; }
     /** @returns */
-    [[nodiscard]] Player& getPlayer() noexcept                          { return player; }
-    /** @returns */
-    [[nodiscard]] const Player& getPlayer() const noexcept              { return player; }
+    [[nodiscard]] const WorldTicker& getTicker() const noexcept         { return ticker; }
+
+    /** Finds the world's objects that the words could be naming, best first,
+        optionally only within an area (eg: the room the player is in).
+
+        @see NameIndex::findMatches
+    */
+    int findObjectsNamed (std::span<const std::string_view> words, Array<NameIndex::Match>& results,
+                          Rectangle<int> within = {}) const
+    {
+        return nameIndex.findMatches (words, results, within);
+    }
+
+    /** @returns the names of the maps that the world's DoorTiles and StairTiles link to.
+        @see MapLink
+    */
+    [[nodiscard]] StringArray getLinkedMapNames() const
+    {
+        StringArray names;
+
+        for (const auto& child : world)
+            if (MapLink::hasDestination (child))
+                names.addIfNotAlreadyThere (MapLink::getDestinationMap (child));
+
+        return names;
+    }
+
+    /** @returns a rough estimate of the number of bytes this map holds on to.
+        @see WorldManager
+    */
+    [[nodiscard]] size_t getEstimatedMemoryUsage() const
+    {
+        return sizeof (GameMap) + tileGrid.getMemoryUsage() + estimateMemoryUsage (state);
+    }
 
     //==============================================================================
-    /** */
+    /** Adds an object to the world, at the position.
+        Tiles go through setTile() or promoteTile() instead, so that they block sight.
+    */
     GameMap& setWorldObject (WorldObject& wo, Point<int> position, UndoManager* undoManager = nullptr)
     {
+        jassert (! wo.getState().hasType (tileId));
+
         wo.setPosition (position);
         world.appendChild (wo.getState(), undoManager);
         return *this;
@@ -145,6 +364,71 @@ public:
         return *this;
     }
 
+    //==============================================================================
+    /** @returns the dense store of this map's tiles. */
+    [[nodiscard]] TileGrid& getTileGrid() noexcept                      { return tileGrid; }
+    /** @returns */
+    [[nodiscard]] const TileGrid& getTileGrid() const noexcept          { return tileGrid; }
+
+    /** Places a plain tile in the tile grid, replacing whatever was at the position.
+
+        None of the tile edits are undoable: the tile grid owns the promoted tiles,
+        so their states can't come and go from the world on their own.
+    */
+    GameMap& setTile (Point<int> position,
+                      EngineTile::Type type,
+                      Material material = Material::stone,
+                      Colour colour = Colours::transparentBlack)
+    {
+        removePromotedTileFromWorld (position);
+        tileGrid.setTile (position, type, material, colour);
+        return *this;
+    }
+
+    /** Promotes a tile with unique state (eg: a DoorTile with Unlockable IDs)
+        into the tile grid, replacing whatever was at the position,
+        and adds it to the world and the ticker.
+
+        @returns the promoted tile.
+    */
+    EngineTile& promoteTile (std::unique_ptr<EngineTile> tile, Point<int> position)
+    {
+        removePromotedTileFromWorld (position);
+
+        auto& promoted = tileGrid.promote (position, std::move (tile));
+        world.appendChild (promoted.getState(), nullptr);
+        ticker.add (promoted);
+        return promoted;
+    }
+
+    /** Removes the tile at the position, if any. */
+    GameMap& clearTile (Point<int> position)
+    {
+        removePromotedTileFromWorld (position);
+        tileGrid.clearTile (position);
+        return *this;
+    }
+
+    //==============================================================================
+    /** @returns what the player can see from where they stand, for describing
+        the room and drawing the map, or nothing if the player isn't on this map.
+
+        This is only recomputed when the player moved or a tile started or stopped
+        blocking sight since the last call, so it's fine to call on every move.
+    */
+    [[nodiscard]] const FieldOfView& getFieldOfView()
+    {
+        if (player != nullptr)
+            fieldOfView.update (tileGrid, player->getPosition());
+        else
+            fieldOfView.clear();
+
+        return fieldOfView;
+    }
+
+    /** @returns true if the player can see the position. */
+    [[nodiscard]] bool canPlayerSee (Point<int> position)    { return getFieldOfView().isVisible (position); }
+
 private:
     //==============================================================================
     ValueTree world { worldId },
@@ -153,42 +437,54 @@ private:
               weapons { weaponsId },
               npcs { npcsId },
               moves { movesId },
-              inanimateObjects { inanimateObjectsId };
+              inanimateObjects { inanimateObjectsId },
+              tileGridState { tileGridId };
 
-    Player& player;
+    DefinitionIndex definitionIndex { definitions };
+    SpatialIndex spatialIndex { world };
+    NameIndex nameIndex { world, [this] (const String& definitionKey) { return findDefinition (definitionKey); } };
+    StatusIndex statusIndex { world, definitions, [this] (const String& definitionKey) { return findDefinition (definitionKey); } };
+    TileGrid tileGrid { tileGridState };
+    FieldOfView fieldOfView;
+    WorldTicker ticker;
+    LiveObjects liveObjects { world, ticker, [this] (const ValueTree& child) { return findPrototypeOf (child); } };
 
-    StairTile testStairTileBlocked { StairTile::Direction::blocked },
-              testStairTileUp { StairTile::Direction::up },
-              testStairTileDown { StairTile::Direction::down };
+    Player* player = nullptr;
 
-    DoorTile testDoorTileUnlocked { DoorLockState::unlocked },
-             testDoorTileNeedsKey { DoorLockState::needsKey },
-             testDoorTileNeedsSpell { DoorLockState::needsSpell },
-             testDoorTileImpassable { DoorLockState::impassable };
-
-    DoorTile testSecretDoorTileUnlocked { DoorLockState::unlocked, true },
-             testSecretDoorTileNeedsKey { DoorLockState::needsKey, true },
-             testSecretDoorTileNeedsSpell { DoorLockState::needsSpell, true },
-             testSecretDoorTileImpassable { DoorLockState::impassable, true };
+    //==============================================================================
+    /** Wraps a saved tile in the class of its type, for the types whose update() does something. */
+    [[nodiscard]] static std::unique_ptr<EngineTile> wrapTile (const ValueTree& tileState)
+    {
+        if (static_cast<EngineTile::Type> (static_cast<int> (tileState[typeId])) == EngineTile::Type::door)
+            return std::make_unique<DoorTile> (tileState);
 
-    WallTile testWallTile1 { Material::vinyl, Colours::white },
-             testWallTile2 { Material::ooze, Colours::red };
+        return std::make_unique<EngineTile> (tileState);
+    }
 
     //==============================================================================
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GameMap)
-};
+    /** Roughly a ValueTree's shared object per node, plus an entry per property. */
+    [[nodiscard]] static size_t estimateMemoryUsage (const ValueTree& tree)
+    {
+        constexpr size_t bytesPerNode = 128, bytesPerProperty = 32;
 
-//==============================================================================
-/** */
-class WorldEntityDefinitionParser
-{
-public:
-    /** */
-    WorldEntityDefinitionParser() = default;
-    /** */
-    virtual ~WorldEntityDefinitionParser() = default;
+        auto total = bytesPerNode + static_cast<size_t> (tree.getNumProperties()) * bytesPerProperty;
+
+        for (const auto& child : tree)
+            total += estimateMemoryUsage (child);
+
+        return total;
+    }
 
-private:
     //==============================================================================
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WorldEntityDefinitionParser)
+    void removePromotedTileFromWorld (Point<int> position)
+    {
+        if (auto* existing = tileGrid.getPromotedTile (position))
+        {
+            ticker.remove (*existing);
+            world.removeChild (existing->getState(), nullptr);
+        }
+    }
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GameMap)
 };
@@ -1,137 +1,363 @@
-namespace
-{
-    enum class GameCommandIDs
-    {
-        pickUp,
-        talk,
-        push,
-        pull,
-        
-    };
-}
-
 /** */
 class GameProcessor final
 {
 public:
-    /** */
-    GameProcessor (UndoManager* undoManager = nullptr) :
-        player (CardinalDirection::north, undoManager),
-        gameMap (player, undoManager)
+    /** @param prefetchPool If not nullptr, the world prefetches maps on this pool instead of its own thread,
+                            and content is parsed on it too. It must outlive the GameProcessor.
+        @see WorldManager, ContentLoader
+    */
+    GameProcessor (UndoManager* undoManagerToUse = nullptr, ThreadPool* prefetchPool = nullptr) :
+        player (CardinalDirection::north, undoManagerToUse),
+        worldManager (player, [this] (const String& mapName) { return loadMap (mapName); },
+                      WorldManager::defaultMemoryBudget, prefetchPool),
+        sharedPool (prefetchPool)
     {
+        worldManager.onMapEvicted = [this] (const String& mapName, GameMap& map) { keepEvictedMap (mapName, map); };
+        worldManager.enterMap (startingMapName, player.getPosition());
+        registerCommands();
     }
 
-    std::optional<Result> processCheatMessage (const StringArray& parts)
-    {
-        const auto& command = parts.getReference (0);
-        auto matches = [&] (StringRef c)
-        {
-            return command.equalsIgnoreCase (c);
-        };
+    /** The name of the map the player starts on. */
+    static constexpr auto startingMapName = "start";
 
-        if (matches ("kill"))
-        {
-            jassertfalse;
-        }
-        else if (matches ("add"))
+    /** Loads the definitions of a content folder, like "content/TheDarkFable", into the current map.
+
+        The loader, along with its threads, is made on the first call and kept for the next ones.
+
+        @see ContentLoader
+    */
+    [[nodiscard]] Result loadContent (const File& contentFolder)
+    {
+        if (contentLoader == nullptr)
         {
-            jassertfalse; // add {item id} {x, y}
+            contentLoader = sharedPool != nullptr ? std::make_unique<ContentLoader> (*sharedPool)
+                                                  : std::make_unique<ContentLoader>();
         }
-        else if (matches ("remove"))
+
+        return contentLoader->load (contentFolder, getCurrentMap());
+    }
+
+    /** @returns the map the player is on. */
+    [[nodiscard]] GameMap& getCurrentMap() const
+    {
+        auto* map = worldManager.getCurrentMap();
+        jassert (map != nullptr);
+        return *map;
+    }
+
+    //==============================================================================
+    /** Reseeds the random number generator that the game's mechanics draw from. */
+    void setSeed (int64 newSeed)
+    {
+        seed = newSeed;
+        random.setSeed (newSeed);
+    }
+
+    /** @returns the seed that the random number generator was last given. */
+    [[nodiscard]] int64 getSeed() const noexcept        { return seed; }
+    /** @returns the random number generator that the game's mechanics should draw from, so that sessions can be replayed. */
+    [[nodiscard]] Random& getRandom() noexcept          { return random; }
+
+    /** Moves the game forward by one tick, applying the effects of any status conditions
+        on the current map, then updating its objects that changed or have a timer due.
+        @see StatusEngine, WorldTicker
+    */
+    void advanceTick()
+    {
+        ++tick;
+
+        if (journal != nullptr)
+            journal->markTick (tick);
+
+        worldManager.update();
+
+        if (auto* map = worldManager.getCurrentMap())
         {
-            jassertfalse; // remove {item id} {x, y}
+            statusEngine.tick (*map, random); // Not undoable: undo is for the player's commands, not the game's mechanics.
+            map->getTicker().tick();
         }
-        else if (matches ("set"))
+    }
+
+    /** @returns the engine that applies the status conditions, such as to find out who loses their turn. */
+    [[nodiscard]] const StatusEngine& getStatusEngine() const noexcept { return statusEngine; }
+
+    /** @returns the number of ticks the game has gone through. */
+    [[nodiscard]] uint64 getTick() const noexcept       { return tick; }
+
+    //==============================================================================
+    /** Starts recording every accepted command, and the tick it was accepted at, to the journal,
+        along with the last tick the game goes through.
+        Commands that fail aren't recorded, since they don't change the game.
+
+        The random number generator is reseeded with the journal's seed,
+        so to be able to replay the journal, start recording on a freshly
+        created processor.
+
+        @see replay
+    */
+    void startRecording (CommandJournal& journalToUse)
+    {
+        setSeed (journalToUse.getSeed());
+        journal = &journalToUse;
+    }
+
+    /** Stops recording, flushing the journal so that it ends with the last tick the game got to. */
+    void stopRecording()
+    {
+        if (journal != nullptr)
+            journal->flush();
+
+        journal = nullptr;
+    }
+
+    /** Replays a journal as fast as possible, advancing the ticks and reseeding
+        the random number generator just as they were when it was recorded.
+
+        For the results to match the recorded session, this must be called on a
+        freshly created processor, and nothing is recorded while replaying.
+
+        @returns the number of commands that failed, which should be none,
+                 since only the commands that were accepted are recorded.
+    */
+    int replay (const CommandJournal& journalToReplay)
+    {
+        jassert (tick == 0); // Replaying onto a processor that's already been played with won't be deterministic!
+
+        const ScopedValueSetter<CommandJournal*> svs (journal, nullptr);
+        setSeed (journalToReplay.getSeed());
+
+        int numFailed = 0;
+
+        for (int i = 0; i < journalToReplay.size(); ++i)
         {
-            /**
-                set {id} {v}
-            */
-            jassertfalse;
+            while (tick < journalToReplay.getTick (i))
+                advanceTick();
+
+            if (processMessage (journalToReplay.getCommand (i)).failed())
+                ++numFailed;
         }
-        else if (matches ("player"))
+
+        // Catches up with the ticks that went by after the last command:
+        while (tick < journalToReplay.getLastTick())
+            advanceTick();
+
+        return numFailed;
+    }
+
+    //==============================================================================
+    /** @returns the commands that players can use, to which custom commands can be added. */
+    [[nodiscard]] CommandTable& getCommands() noexcept          { return commands; }
+    /** @returns the commands that are only available while cheats are allowed. */
+    [[nodiscard]] CommandTable& getCheatCommands() noexcept     { return cheatCommands; }
+
+    /** */
+    std::optional<Result> processCheatMessage (const CommandTokenizer& parts)
+    {
+        return cheatCommands.dispatch (parts);
+    }
+
+    /** Carries out a command typed by the player.
+        This doesn't allocate to split up and recognise the command.
+        @see CommandTokenizer, CommandTable
+    */
+    Result processMessage (std::string_view message)
+    {
+        if (! tokenizer.tokenize (message))
+            return Result::fail (TRANS ("That's too much to take in..."));
+
+        if (tokenizer.isEmpty())
+            return Result::fail (TRANS ("What do you want to do?"));
+
+        const auto result = dispatch();
+
+        if (journal != nullptr && result.wasOk())
+            journal->append (tick, message);
+
+        return result;
+    }
+
+    /** @see processMessage */
+    Result processMessage (const String& message)
+    {
+        return processMessage (std::string_view (message.toRawUTF8(), message.getNumBytesAsUTF8()));
+    }
+
+    /** @see processMessage */
+    Result processMessage (const char* message)
+    {
+        return processMessage (std::string_view (message));
+    }
+
+    /** Carries out a batch of commands in order, all within the current tick.
+
+        @param messages The commands to carry out.
+        @param results  If not nullptr, the result of each command is added to this.
+
+        @returns the number of commands that failed.
+    */
+    int processMessages (std::span<const std::string_view> messages, Array<Result>* results = nullptr)
+    {
+        return processEach (messages, results);
+    }
+
+    /** @see processMessages */
+    int processMessages (const StringArray& messages, Array<Result>* results = nullptr)
+    {
+        return processEach (messages, results);
+    }
+
+    bool allowCheats = true;
+    Player player;
+
+private:
+    // The evicted maps, as snapshots, for the loader to bring back as they were left.
+    // These must outlive the worldManager, since it loads maps on its prefetching thread.
+    CriticalSection evictedMapLock;
+    HashMap<String, MemoryBlock> evictedMaps;
+
+public:
+    WorldManager worldManager;
+
+private:
+    //==============================================================================
+    CommandTokenizer tokenizer;
+    CommandTable commands, cheatCommands;
+    StatusEngine statusEngine;
+
+    int64 seed = 0;
+    Random random { seed };
+    uint64 tick = 0;
+    CommandJournal* journal = nullptr;
+
+    ThreadPool* const sharedPool;
+    std::unique_ptr<ContentLoader> contentLoader;
+
+    //==============================================================================
+    Result dispatch()
+    {
+        if (const auto r = commands.dispatch (tokenizer); r.has_value())
+            return *r;
+
+        if (allowCheats)
+            if (const auto r = processCheatMessage (tokenizer); r.has_value())
+                return *r;
+
+        // A word the game knows as a verb, but that no command handles yet:
+        if (const auto verb = VerbTable::find (tokenizer[0]); verb != VerbTable::notFound)
+            return Result::fail (TRANS ("You don't know how to") + " " + VerbTable::getVerb (verb) + "...");
+
+        return Result::fail (TRANS ("You can't do that here..."));
+    }
+
+    /** Called by the worldManager, from either thread. */
+    std::unique_ptr<GameMap> loadMap (const String& mapName)
+    {
         {
-            if (matches ("tgm"))
-            {
-                jassertfalse;
-            }
-            else if (matches ("add"))
-            {
-                jassertfalse;
-            }
-            else if (matches ("remove"))
-            {
-                jassertfalse;
-            }
-            else if (matches ("set"))
+            const ScopedLock sl (evictedMapLock);
+
+            if (evictedMaps.contains (mapName))
             {
-                /**
-                    player set {id} {v}
-                    player set level {v}
-                */
+                const auto& snapshot = evictedMaps.getReference (mapName);
+                const auto state = BinarySnapshot::read (snapshot.getData(), snapshot.getSize());
+
+                if (state.hasType (gameMapId))
+                    return std::make_unique<GameMap> (state);
+
                 jassertfalse;
             }
         }
 
-        return Result::ok();
+        if (mapName != startingMapName)
+            return {};
+
+        auto map = std::make_unique<GameMap>();
+        map->setName (mapName);
+        map->addTestData();
+        return map;
     }
 
-    Result processMessage (String message)
+    void keepEvictedMap (const String& mapName, GameMap& map)
     {
-        const auto parts = [&]()
-        {
-            auto toks = StringArray::fromTokens (toLowerCase (message), " ", "\"'");
-            toks.trim();
-            toks.removeEmptyStrings (true);
-            toks.minimiseStorageOverheads();
-            return toks;
-        }();
-
-        if (parts.isEmpty())
-        {
-            jassertfalse; // fail + return commands
-        }
+        MemoryOutputStream output;
+        BinarySnapshot::write (map.getState(), output);
 
-        const auto& command = parts.getReference (0);
-        auto matches = [&] (StringRef c)
-        {
-            return command.equalsIgnoreCase (c);
-        };
+        const ScopedLock sl (evictedMapLock);
+        evictedMaps.set (mapName, output.getMemoryBlock());
+    }
 
-        if (matches ("help"))
-        {
-            jassertfalse;
-        }
-        else if (matches ("quit")
-                 || matches ("exit"))
-        {
-            jassertfalse;
-        }
-        else if (matches ("move"))
+    /** Takes the player through the DoorTile or StairTile they're standing on. */
+    Result followLinkAtPlayer()
+    {
+        ValueTree link;
+
+        getCurrentMap().getSpatialIndex().forEachObjectAt (player.getPosition(), [&] (const ValueTree& v)
         {
-            jassertfalse;
-        }
-        else
+            if (! link.isValid() && MapLink::hasDestination (v))
+                link = v;
+        });
+
+        if (! link.isValid())
+            return Result::fail (TRANS ("There's nowhere to go from here..."));
+
+        if (link.hasProperty (lockStateId)
+            && VariantConverter<DoorLockState>::fromVar (link[lockStateId]) != DoorLockState::unlocked)
+            return Result::fail (TRANS ("It's locked..."));
+
+        if (worldManager.followLink (link) == nullptr)
+            return Result::fail (TRANS ("The way is blocked..."));
+
+        return Result::ok();
+    }
+
+    //==============================================================================
+    template<typename Messages>
+    int processEach (const Messages& messages, Array<Result>* results)
+    {
+        int numFailed = 0;
+
+        if (results != nullptr)
+            results->ensureStorageAllocated (results->size() + (int) std::size (messages));
+
+        for (const auto& message : messages)
         {
-            if (allowCheats)
-                if (const auto r = processCheatMessage (parts); r.has_value())
-                    return *r;
+            const auto r = processMessage (message);
+
+            if (r.failed())
+                ++numFailed;
 
-            return Result::fail (TRANS ("You can't do that here..."));
+            if (results != nullptr)
+                results->add (r);
         }
 
-        return Result::ok();
+        return numFailed;
     }
 
-    bool allowCheats = true;
-    Player player;
-    GameMap gameMap;
+    void registerCommands()
+    {
+        auto notImplemented = [] (const CommandTokenizer&, int)
+        {
+            return Result::fail (TRANS ("That isn't implemented yet..."));
+        };
 
-private:
-    /** TODO:
-        Create a giant list of GameMap objects, 1:1 with each room/environment.
-        They should be called up via a static UUID or some other identifier.
-    */
-    // OwnedArray<GameMap> gameMaps;
+        commands.add ("help", GameCommandIDs::help, notImplemented);
+        commands.add ("quit", GameCommandIDs::quit, notImplemented);
+        commands.addAlias ("exit", "quit");
+        commands.add ("move", GameCommandIDs::move, notImplemented);
+        commands.add ("enter", GameCommandIDs::enter, [this] (const CommandTokenizer&, int) { return followLinkAtPlayer(); });
+        commands.addAlias ("climb", "enter");
+
+        cheatCommands.add ("kill", GameCommandIDs::kill, notImplemented);
+        cheatCommands.add ("add", GameCommandIDs::add, notImplemented);        // add {item id} {x, y}
+        cheatCommands.add ("remove", GameCommandIDs::remove, notImplemented);  // remove {item id} {x, y}
+        cheatCommands.add ("set", GameCommandIDs::set, notImplemented);        // set {id} {v}
+
+        auto& playerCommands = cheatCommands.add ("player", GameCommandIDs::player).getSubcommands();
+        playerCommands.add ("tgm", GameCommandIDs::playerGodMode, notImplemented);
+        playerCommands.add ("add", GameCommandIDs::playerAdd, notImplemented);
+        playerCommands.add ("remove", GameCommandIDs::playerRemove, notImplemented);
+        playerCommands.add ("set", GameCommandIDs::playerSet, notImplemented); // player set {id} {v}, player set level {v}
+    }
 
+    //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GameProcessor)
 };
@@ -0,0 +1,454 @@
+//==============================================================================
+MoveSelector::BattleState MoveSelector::BattleState::from (const GameMap& map, const ValueTree& enemyState, const ValueTree& opponentState)
+{
+    const auto readPowerPoints = [] (const FightableEntityView& view)
+    {
+        std::vector<int> powerPoints;
+
+        for (int i = 0; i < view.getNumFightingMoves(); ++i)
+            powerPoints.push_back (jmax (0, FightingMoveView (view.getFightingMoveState (i)).getPowerPoints()));
+
+        return powerPoints;
+    };
+
+    const auto enemyPrototype = map.findPrototypeOf (enemyState).definition;
+    const auto opponentPrototype = map.findPrototypeOf (opponentState).definition;
+    const FightableEntityView enemy (enemyState, enemyPrototype), opponent (opponentState, opponentPrototype);
+
+    BattleState s;
+    s.enemy = BattleCombatant::from (enemyState, enemyPrototype);
+    s.opponent = BattleCombatant::from (opponentState, opponentPrototype);
+    s.enemyHitPoints = enemy.getHitPoints();
+    s.opponentHitPoints = opponent.getHitPoints();
+    s.enemyPowerPoints = readPowerPoints (enemy);
+    s.opponentPowerPoints = readPowerPoints (opponent);
+    return s;
+}
+
+//==============================================================================
+/** A node is reached by a choice of move, and its children are the next side's choices.
+    The children of a node are next to each other, one per move plus one for struggling.
+*/
+struct MoveSelector::Node final
+{
+    int firstChild = -1, numChildren = 0;
+    int visits = 0;
+    double totalValue = 0.0;    // From the enemy's point of view: 1 is a win, 0 a loss.
+};
+
+//==============================================================================
+struct MoveSelector::Task final
+{
+    enum class Type
+    {
+        decide,
+        advance,
+        reset
+    };
+
+    Type type = Type::decide;
+    BattleState state;
+    double deadline = 0.0;
+    DecisionCallback onDecided;
+    int enemyMoveIndex = -1, opponentMoveIndex = -1;
+};
+
+//==============================================================================
+class MoveSelector::Search final
+{
+public:
+    explicit Search (int64 seed) :
+        random (seed)
+    {
+        clear();
+    }
+
+    void clear()
+    {
+        nodes.clear();
+        nodes.emplace_back();
+    }
+
+    [[nodiscard]] int getNumNodes() const noexcept { return (int) nodes.size(); }
+
+    //==============================================================================
+    /** @returns the chosen move's index, or -1 to struggle. */
+    int decide (const BattleState& state, double deadline, int& numIterations)
+    {
+        numIterations = 0;
+
+        // A tree kept from a battle where the enemy had a different set of moves is of no use:
+        if (const auto& root = nodes.front(); root.firstChild >= 0 && root.numChildren != (int) state.enemy.moves.size() + 1)
+            clear();
+
+        do
+        {
+            for (int i = 0; i < iterationsPerTimeCheck; ++i)
+                iterate (state);
+
+            numIterations += iterationsPerTimeCheck;
+        }
+        while (Time::getMillisecondCounterHiRes() < deadline && ! Thread::currentThreadShouldExit());
+
+        // The most visited is the most trusted:
+        const auto& root = nodes.front();
+        auto best = -1, bestVisits = -1;
+
+        forEachLegalSlot (state.enemy, state.enemyPowerPoints, [&] (int slot)
+        {
+            const auto visits = root.firstChild >= 0 && isPositiveAndBelow (slot, root.numChildren)
+                              ? nodes[(size_t) (root.firstChild + slot)].visits
+                              : 0;
+
+            if (visits > bestVisits)
+            {
+                best = slot;
+                bestVisits = visits;
+            }
+        });
+
+        return best < (int) state.enemy.moves.size() ? best : -1;
+    }
+
+    /** Keeps the part of the tree below the moves used, as the new root. */
+    void advance (int enemyMoveIndex, int opponentMoveIndex)
+    {
+        const auto enemyChild = getChild (0, enemyMoveIndex);
+        const auto opponentChild = enemyChild >= 0 ? getChild (enemyChild, opponentMoveIndex) : -1;
+
+        if (opponentChild < 0)
+        {
+            clear();
+            return;
+        }
+
+        // Copies the subtree breadth first, which keeps each node's children next to each other:
+        std::vector<Node> kept;
+        kept.push_back (nodes[(size_t) opponentChild]);
+
+        for (size_t i = 0; i < kept.size(); ++i)
+        {
+            const auto oldFirstChild = kept[i].firstChild;
+            if (oldFirstChild < 0)
+                continue;
+
+            kept[i].firstChild = (int) kept.size();
+
+            for (int c = 0; c < kept[i].numChildren; ++c)
+                kept.push_back (nodes[(size_t) (oldFirstChild + c)]);
+        }
+
+        nodes.swap (kept);
+    }
+
+private:
+    //==============================================================================
+    static constexpr int iterationsPerTimeCheck = 32;
+    static constexpr int maxTurns = 50;
+    static constexpr double exploration = 0.7;
+
+    std::vector<Node> nodes; // The root is always the first.
+    Random random;
+
+    // The battle being played out by the current iteration:
+    std::vector<int> path, enemyPowerPoints, opponentPowerPoints;
+    int enemyHitPoints = 0, opponentHitPoints = 0;
+
+    //==============================================================================
+    [[nodiscard]] int getChild (int node, int moveIndex) const noexcept
+    {
+        const auto& n = nodes[(size_t) node];
+
+        if (n.firstChild < 0)
+            return -1;
+
+        // The last child is for struggling:
+        const auto slot = moveIndex < 0 ? n.numChildren - 1 : moveIndex;
+        return isPositiveAndBelow (slot, n.numChildren) ? n.firstChild + slot : -1;
+    }
+
+    template<typename Callback>
+    static void forEachLegalSlot (const BattleCombatant& combatant, const std::vector<int>& powerPoints, Callback&& callback)
+    {
+        auto anyLeft = false;
+
+        for (size_t i = 0; i < powerPoints.size(); ++i)
+        {
+            if (powerPoints[i] > 0)
+            {
+                anyLeft = true;
+                callback ((int) i);
+            }
+        }
+
+        if (! anyLeft)
+            callback ((int) combatant.moves.size());
+    }
+
+    /** Uses up a power point of the move in the slot, unless it's the struggle slot. */
+    static void spend (std::vector<int>& powerPoints, int slot)
+    {
+        if (isPositiveAndBelow (slot, (int) powerPoints.size()))
+            --powerPoints[(size_t) slot];
+    }
+
+    //==============================================================================
+    void iterate (const BattleState& state)
+    {
+        enemyHitPoints = state.enemyHitPoints;
+        opponentHitPoints = state.opponentHitPoints;
+        enemyPowerPoints = state.enemyPowerPoints;
+        opponentPowerPoints = state.opponentPowerPoints;
+
+        path.clear();
+        path.push_back (0);
+
+        int node = 0, enemySlot = -1, turns = 0;
+        auto enemyToMove = true;
+
+        while (enemyHitPoints > 0 && opponentHitPoints > 0 && turns < maxTurns)
+        {
+            const auto& combatant = enemyToMove ? state.enemy : state.opponent;
+            auto& powerPoints = enemyToMove ? enemyPowerPoints : opponentPowerPoints;
+
+            if (nodes[(size_t) node].firstChild < 0)
+            {
+                const auto numChildren = (int) combatant.moves.size() + 1;
+
+                if ((int) nodes.size() + numChildren > maxNodes)
+                    break;
+
+                nodes[(size_t) node].firstChild = (int) nodes.size();
+                nodes[(size_t) node].numChildren = numChildren;
+                nodes.resize (nodes.size() + (size_t) numChildren);
+            }
+
+            const auto slot = select (node, combatant, powerPoints, enemyToMove);
+            if (slot < 0)
+                break; // The node was grown for a different set of moves.
+
+            const auto child = nodes[(size_t) node].firstChild + slot;
+            spend (powerPoints, slot);
+
+            if (enemyToMove)
+            {
+                enemySlot = slot;
+            }
+            else
+            {
+                playTurn (state, enemySlot, slot);
+                ++turns;
+            }
+
+            enemyToMove = ! enemyToMove;
+            node = child;
+            path.push_back (child);
+
+            if (nodes[(size_t) child].visits == 0)
+                break; // A new leaf: play the rest out at random.
+        }
+
+        const auto value = playOut (state, enemyToMove ? -1 : enemySlot, turns);
+
+        for (const auto n : path)
+        {
+            auto& visited = nodes[(size_t) n];
+            ++visited.visits;
+            visited.totalValue += value;
+        }
+    }
+
+    /** Picks an untried move if there is one, and otherwise the one with the best upper confidence bound,
+        which for the opponent is the one that's worst for the enemy.
+
+        @returns -1 if none of the legal moves have a child, like when the combatant's
+                 moves changed since the node was grown.
+    */
+    [[nodiscard]] int select (int node, const BattleCombatant& combatant, const std::vector<int>& powerPoints, bool isEnemy) const
+    {
+        const auto& parent = nodes[(size_t) node];
+        const auto logVisits = std::log ((double) jmax (1, parent.visits));
+
+        auto best = -1;
+        auto bestScore = -std::numeric_limits<double>::infinity();
+
+        forEachLegalSlot (combatant, powerPoints, [&] (int slot)
+        {
+            if (! isPositiveAndBelow (slot, parent.numChildren))
+                return;
+
+            const auto& child = nodes[(size_t) (parent.firstChild + slot)];
+
+            const auto score = child.visits == 0
+                             ? std::numeric_limits<double>::infinity()
+                             : (isEnemy ? 0.0 : 1.0) + (isEnemy ? 1.0 : -1.0) * child.totalValue / child.visits
+                                + exploration * std::sqrt (logVisits / child.visits);
+
+            if (score > bestScore)
+            {
+                best = slot;
+                bestScore = score;
+            }
+        });
+
+        return best;
+    }
+
+    void playTurn (const BattleState& state, int enemySlot, int opponentSlot)
+    {
+        const auto& enemyMove = state.enemy.getMove (enemySlot);
+        const auto& opponentMove = state.opponent.getMove (opponentSlot);
+
+        const auto enemyAttacks = [&]
+        {
+            opponentHitPoints -= state.enemy.attackWith (enemyMove, state.opponent, random);
+            return opponentHitPoints <= 0;
+        };
+
+        const auto opponentAttacks = [&]
+        {
+            enemyHitPoints -= state.opponent.attackWith (opponentMove, state.enemy, random);
+            return enemyHitPoints <= 0;
+        };
+
+        if (state.enemy.actsBefore (enemyMove, state.opponent, opponentMove, random))
+            ignoreUnused (enemyAttacks() || opponentAttacks());
+        else
+            ignoreUnused (opponentAttacks() || enemyAttacks());
+    }
+
+    int pickAtRandom (const BattleCombatant& combatant, std::vector<int>& powerPoints)
+    {
+        int numLegal = 0;
+        forEachLegalSlot (combatant, powerPoints, [&] (int) { ++numLegal; });
+
+        auto pick = random.nextInt (numLegal);
+        auto chosen = -1;
+        forEachLegalSlot (combatant, powerPoints, [&] (int slot) { if (pick-- == 0) chosen = slot; });
+
+        spend (powerPoints, chosen);
+        return chosen;
+    }
+
+    /** Plays the battle out with random moves, finishing the turn whose enemy move is pending, if any.
+        @returns the outcome, from the enemy's point of view.
+    */
+    double playOut (const BattleState& state, int pendingEnemySlot, int turns)
+    {
+        for (; enemyHitPoints > 0 && opponentHitPoints > 0 && turns < maxTurns; ++turns)
+        {
+            const auto enemySlot = pendingEnemySlot >= 0 ? pendingEnemySlot : pickAtRandom (state.enemy, enemyPowerPoints);
+            pendingEnemySlot = -1;
+
+            playTurn (state, enemySlot, pickAtRandom (state.opponent, opponentPowerPoints));
+        }
+
+        if (opponentHitPoints <= 0) return 1.0;
+        if (enemyHitPoints <= 0)    return 0.0;
+
+        // Undecided, so judge by who's the most hurt:
+        return 0.5 + 0.5 * ((double) enemyHitPoints / state.enemy.maxHitPoints
+                            - (double) opponentHitPoints / state.opponent.maxHitPoints);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Search)
+};
+
+//==============================================================================
+MoveSelector::MoveSelector (int64 seed) :
+    Thread ("Move Selector"),
+    search (std::make_unique<Search> (seed))
+{
+    startThread();
+}
+
+MoveSelector::~MoveSelector()
+{
+    signalThreadShouldExit();
+    notify();
+    stopThread (-1);
+}
+
+void MoveSelector::push (Task&& task)
+{
+    {
+        const ScopedLock sl (lock);
+        pending.push_back (std::move (task));
+    }
+
+    notify();
+}
+
+void MoveSelector::requestDecision (BattleState state, double budgetMilliseconds, DecisionCallback onDecided)
+{
+    Task task;
+    task.type = Task::Type::decide;
+    task.state = std::move (state);
+    task.deadline = Time::getMillisecondCounterHiRes() + jmax (0.0, budgetMilliseconds);
+    task.onDecided = std::move (onDecided);
+    push (std::move (task));
+}
+
+void MoveSelector::advance (int enemyMoveIndex, int opponentMoveIndex)
+{
+    Task task;
+    task.type = Task::Type::advance;
+    task.enemyMoveIndex = enemyMoveIndex;
+    task.opponentMoveIndex = opponentMoveIndex;
+    push (std::move (task));
+}
+
+void MoveSelector::reset()
+{
+    Task task;
+    task.type = Task::Type::reset;
+    push (std::move (task));
+}
+
+//==============================================================================
+void MoveSelector::run()
+{
+    std::vector<Task> batch;
+
+    while (! threadShouldExit())
+    {
+        {
+            const ScopedLock sl (lock);
+            batch.swap (pending);
+        }
+
+        if (batch.empty())
+        {
+            wait (-1);
+            continue;
+        }
+
+        for (auto& task : batch)
+        {
+            if (threadShouldExit())
+                break;
+
+            switch (task.type)
+            {
+                case Task::Type::decide:
+                {
+                    int numIterations = 0;
+                    const auto moveIndex = search->decide (task.state, task.deadline, numIterations);
+                    lastNumIterations = numIterations;
+
+                    if (task.onDecided != nullptr)
+                        task.onDecided (moveIndex);
+                }
+                break;
+
+                case Task::Type::advance:   search->advance (task.enemyMoveIndex, task.opponentMoveIndex); break;
+                case Task::Type::reset:     search->clear(); break;
+                default:                    jassertfalse; break;
+            }
+
+            numNodes = search->getNumNodes();
+        }
+
+        batch.clear();
+    }
+}
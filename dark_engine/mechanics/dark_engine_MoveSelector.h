@@ -0,0 +1,90 @@
+//==============================================================================
+/** Picks the moves of an enemy FightableEntity by searching the battle ahead,
+    within a hard time budget per decision, on its own thread.
+
+    The search is a Monte Carlo tree search over the enemy's and its opponent's
+    choices of move, where each turn is the enemy's choice and then the
+    opponent's reply, picked to be the worst for the enemy. The tree is
+    open-loop: it's keyed by the moves chosen rather than by the exact hit points
+    they led to, and every iteration plays the turns out again with fresh rolls,
+    so that the randomness of the damage and accuracy is averaged over. Once a
+    path runs out of tree, the rest of the battle is played out at random.
+
+    After each turn, call advance() with the moves that were actually used:
+    the part of the tree below them is kept as the root for the next decision,
+    so that none of the search already done for that turn is wasted.
+
+    Everything is done on the selector's thread: requesting a decision never blocks,
+    and the callback is called on that thread once the budget has been spent.
+
+    @see BattleCombatant, TurnScheduler, BattleSimulator
+*/
+class MoveSelector final : private Thread
+{
+public:
+    /** The state of a battle, from the enemy's point of view. */
+    struct BattleState final
+    {
+        BattleCombatant enemy, opponent;
+        int enemyHitPoints = 0, opponentHitPoints = 0;
+        std::vector<int> enemyPowerPoints, opponentPowerPoints;
+
+        /** Reads the battle from the states of two FightableEntities on the map, as they currently are,
+            falling back to the definitions they were made from for anything they don't override.
+        */
+        static BattleState from (const GameMap& map, const ValueTree& enemyState, const ValueTree& opponentState);
+    };
+
+    /** Called on the selector's thread with the index of the enemy's chosen FightingMove,
+        or -1 if it has no power points left for any, and should struggle.
+    */
+    using DecisionCallback = std::function<void (int moveIndex)>;
+
+    /** */
+    explicit MoveSelector (int64 seed = 0);
+
+    /** Stops searching, dropping any decisions that haven't been made yet. */
+    ~MoveSelector() override;
+
+    //==============================================================================
+    /** Searches for the enemy's best move for the battle as it is, for up to the budget,
+        then calls back with it.
+    */
+    void requestDecision (BattleState state, double budgetMilliseconds, DecisionCallback onDecided);
+
+    /** Moves the root of the tree down past the moves that were used this turn, keeping what's below it.
+        Use -1 for a side that struggled.
+    */
+    void advance (int enemyMoveIndex, int opponentMoveIndex);
+
+    /** Forgets the whole tree, like when a new battle starts. */
+    void reset();
+
+    //==============================================================================
+    /** @returns the number of nodes in the tree. */
+    [[nodiscard]] int getNumNodes() const noexcept              { return numNodes.load (std::memory_order_relaxed); }
+    /** @returns the number of iterations that the last decision ran. */
+    [[nodiscard]] int getLastNumIterations() const noexcept     { return lastNumIterations.load (std::memory_order_relaxed); }
+
+    /** The most nodes the tree can grow to, after which the search only plays out more battles. */
+    static constexpr int maxNodes = 1 << 20;
+
+private:
+    //==============================================================================
+    struct Node;
+    struct Task;
+    class Search;
+
+    CriticalSection lock;
+    std::vector<Task> pending;
+
+    std::unique_ptr<Search> search; // Only touched on the selector's thread.
+    std::atomic<int> numNodes { 0 }, lastNumIterations { 0 };
+
+    //==============================================================================
+    void push (Task&&);
+    void run() override;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MoveSelector)
+};
@@ -0,0 +1,490 @@
+//==============================================================================
+struct SessionHost::Session final
+{
+    Session (ThreadPool& prefetchPool) :
+        processor (&undoManager, &prefetchPool)
+    {
+    }
+
+    UndoManager undoManager;
+    GameProcessor processor;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Session)
+};
+
+//==============================================================================
+struct SessionHost::Task final
+{
+    enum class Type
+    {
+        create,
+        command,
+        close,
+        barrier
+    };
+
+    Type type = Type::command;
+    SessionId sessionId = 0;
+    std::string command;
+    SessionSetup setup;
+    ReplyCallback onReply;
+    std::function<void()> onDone;
+};
+
+//==============================================================================
+/** Owns the sessions whose IDs map to it, which only its thread ever touches. */
+class SessionHost::Worker final : public Thread
+{
+public:
+    Worker (SessionHost& hostToUse, int index) :
+        Thread ("Session Worker " + String (index)),
+        host (hostToUse)
+    {
+    }
+
+    ~Worker() override
+    {
+        signalThreadShouldExit();
+        notify();
+        stopThread (-1);
+    }
+
+    void push (Task&& task)
+    {
+        {
+            const ScopedLock sl (lock);
+            pending.push_back (std::move (task));
+        }
+
+        notify();
+    }
+
+    void run() override
+    {
+        std::vector<Task> batch;
+
+        while (! threadShouldExit())
+        {
+            {
+                const ScopedLock sl (lock);
+                batch.swap (pending);
+            }
+
+            if (batch.empty())
+            {
+                wait (-1);
+                continue;
+            }
+
+            for (auto& task : batch)
+                perform (task);
+
+            batch.clear();
+        }
+
+        // Destroyed here, on the thread that used them:
+        host.numSessions -= (int) sessions.size();
+        sessions.clear();
+    }
+
+private:
+    SessionHost& host;
+
+    CriticalSection lock;
+    std::vector<Task> pending;
+
+    std::unordered_map<SessionId, std::unique_ptr<Session>> sessions;
+
+    void perform (Task& task)
+    {
+        switch (task.type)
+        {
+            case Task::Type::create:
+            {
+                auto session = std::make_unique<Session> (host.prefetchPool);
+
+                if (task.setup != nullptr)
+                    task.setup (session->processor);
+
+                session->undoManager.clearUndoHistory();
+                sessions[task.sessionId] = std::move (session);
+                ++host.numSessions;
+            }
+            break;
+
+            case Task::Type::command:
+            {
+                const auto iter = sessions.find (task.sessionId);
+
+                if (iter == sessions.end())
+                {
+                    if (task.onReply != nullptr)
+                        task.onReply (task.sessionId, Result::fail (TRANS ("There's no such session!")));
+
+                    break;
+                }
+
+                auto& session = *iter->second;
+                session.undoManager.beginNewTransaction();
+
+                const auto r = session.processor.processMessage (std::string_view (task.command));
+
+                if (task.onReply != nullptr)
+                    task.onReply (task.sessionId, r);
+            }
+            break;
+
+            case Task::Type::close:
+                if (sessions.erase (task.sessionId) > 0)
+                    --host.numSessions;
+            break;
+
+            case Task::Type::barrier:
+            break;
+
+            default: jassertfalse; break;
+        }
+
+        if (task.onDone != nullptr)
+            task.onDone();
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Worker)
+};
+
+//==============================================================================
+SessionHost::SessionHost (int numWorkers, int numPrefetchThreads) :
+    prefetchPool (jmax (1, numPrefetchThreads))
+{
+    numWorkers = jmax (1, numWorkers);
+
+    for (int i = 0; i < numWorkers; ++i)
+        workers.add (new Worker (*this, i))->startThread();
+}
+
+SessionHost::~SessionHost()
+{
+    // The sessions must be gone before the pool they prefetch on:
+    workers.clear();
+}
+
+SessionHost::Worker& SessionHost::getWorker (SessionId sessionId) const noexcept
+{
+    return *workers.getUnchecked (static_cast<int> (sessionId % (SessionId) workers.size()));
+}
+
+//==============================================================================
+SessionHost::SessionId SessionHost::createSession (SessionSetup setup)
+{
+    auto sessionId = nextSessionId.fetch_add (1, std::memory_order_relaxed);
+    if (sessionId == 0)
+        sessionId = nextSessionId.fetch_add (1, std::memory_order_relaxed); // Wrapped around.
+
+    Task task;
+    task.type = Task::Type::create;
+    task.sessionId = sessionId;
+    task.setup = std::move (setup);
+
+    getWorker (sessionId).push (std::move (task));
+    return sessionId;
+}
+
+void SessionHost::closeSession (SessionId sessionId, std::function<void()> onClosed)
+{
+    Task task;
+    task.type = Task::Type::close;
+    task.sessionId = sessionId;
+    task.onDone = std::move (onClosed);
+
+    getWorker (sessionId).push (std::move (task));
+}
+
+void SessionHost::post (SessionId sessionId, std::string command, ReplyCallback onReply)
+{
+    Task task;
+    task.sessionId = sessionId;
+    task.command = std::move (command);
+    task.onReply = std::move (onReply);
+
+    getWorker (sessionId).push (std::move (task));
+}
+
+void SessionHost::waitUntilIdle()
+{
+    WaitableEvent done;
+    std::atomic<int> numRemaining { workers.size() };
+
+    for (auto* worker : workers)
+    {
+        Task task;
+        task.type = Task::Type::barrier;
+        task.onDone = [&]
+        {
+            if (--numRemaining == 0)
+                done.signal();
+        };
+
+        worker->push (std::move (task));
+    }
+
+    done.wait (-1);
+}
+
+#if JUCE_LINUX || JUCE_MAC || JUCE_BSD
+
+//==============================================================================
+namespace
+{
+   #ifdef MSG_NOSIGNAL
+    constexpr int sendFlags = MSG_NOSIGNAL;
+   #else
+    constexpr int sendFlags = 0;
+   #endif
+
+    /** Lines longer than this are cut off there, which makes them fail for being too long,
+        and the rest of them is dropped. Leaves room for the '\r' of a "\r\n" line ending.
+    */
+    constexpr size_t maxLineLength = CommandTokenizer::maxMessageLength + 2;
+
+    void setNonBlocking (int socket)
+    {
+        ::fcntl (socket, F_SETFL, ::fcntl (socket, F_GETFL, 0) | O_NONBLOCK);
+    }
+
+    /** Called on a session's worker, so a slow client only ever holds up its own worker,
+        and for no longer than SessionSocketServer::sendTimeoutMs.
+    */
+    void writeLine (int socket, const String& text)
+    {
+        const auto line = text + "\n";
+        const auto* data = line.toRawUTF8();
+        auto numBytes = line.getNumBytesAsUTF8();
+        const auto deadline = Time::getMillisecondCounter() + (uint32) SessionSocketServer::sendTimeoutMs;
+
+        while (numBytes > 0)
+        {
+            const auto numSent = ::send (socket, data, numBytes, sendFlags);
+
+            if (numSent > 0)
+            {
+                data += numSent;
+                numBytes -= (size_t) numSent;
+            }
+            else if (numSent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+            {
+                const auto now = Time::getMillisecondCounter();
+
+                if (now >= deadline)
+                {
+                    // Hung up on, so that the polling thread sees it and disconnects:
+                    ::shutdown (socket, SHUT_RDWR);
+                    return;
+                }
+
+                pollfd fd { socket, POLLOUT, 0 };
+                ::poll (&fd, 1, (int) (deadline - now));
+            }
+            else
+            {
+                return; // Gone: the polling thread will see it and disconnect.
+            }
+        }
+    }
+}
+
+//==============================================================================
+SessionSocketServer::SessionSocketServer (SessionHost& hostToUse, SessionHost::SessionSetup setup) :
+    Thread ("Session Socket Server"),
+    host (hostToUse),
+    sessionSetup (std::move (setup))
+{
+}
+
+SessionSocketServer::~SessionSocketServer()
+{
+    stop();
+}
+
+Result SessionSocketServer::start (const File& socketFileToUse)
+{
+    stop();
+
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+
+    const auto path = socketFileToUse.getFullPathName();
+    if (path.getNumBytesAsUTF8() >= sizeof (address.sun_path))
+        return Result::fail (TRANS ("The socket's path is too long!"));
+
+    path.copyToUTF8 (address.sun_path, sizeof (address.sun_path));
+
+    listener = ::socket (AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0)
+        return Result::fail (TRANS ("Failed to create the socket!"));
+
+    socketFileToUse.deleteFile();
+
+    if (::bind (listener, reinterpret_cast<const sockaddr*> (&address), sizeof (address)) != 0
+        || ::listen (listener, SOMAXCONN) != 0)
+    {
+        ::close (listener);
+        listener = -1;
+        return Result::fail (TRANS ("Failed to listen on the socket!"));
+    }
+
+    setNonBlocking (listener);
+    socketFile = socketFileToUse;
+    startThread();
+    return Result::ok();
+}
+
+void SessionSocketServer::stop()
+{
+    stopThread (-1);
+
+    if (listener >= 0)
+    {
+        ::close (listener);
+        listener = -1;
+        socketFile.deleteFile();
+    }
+}
+
+//==============================================================================
+void SessionSocketServer::run()
+{
+    std::vector<Connection> connections;
+    std::vector<pollfd> fds; // The listener, then one per connection, in the same order.
+    fds.push_back ({ listener, POLLIN, 0 });
+
+    while (! threadShouldExit())
+    {
+        if (::poll (fds.data(), (nfds_t) fds.size(), 100) <= 0)
+            continue;
+
+        if ((fds.front().revents & POLLIN) != 0)
+        {
+            const auto numBefore = connections.size();
+            acceptConnections (connections);
+
+            for (auto i = numBefore; i < connections.size(); ++i)
+                fds.push_back ({ connections[i].socket, POLLIN, 0 });
+        }
+
+        for (size_t i = connections.size(); i > 0; --i)
+        {
+            auto& fd = fds[i];
+
+            if (fd.revents == 0)
+                continue;
+
+            auto& connection = connections[i - 1];
+
+            // Whatever's left to read is carried out before hanging up.
+            const auto stillConnected = (fd.revents & (POLLERR | POLLNVAL)) == 0
+                                     && ((fd.revents & POLLIN) != 0 ? readFrom (connection)
+                                                                     : (fd.revents & POLLHUP) == 0);
+
+            if (! stillConnected)
+            {
+                disconnect (connection);
+
+                if (i < connections.size())
+                {
+                    connection = std::move (connections.back());
+                    fd = fds.back();
+                }
+
+                connections.pop_back();
+                fds.pop_back();
+            }
+        }
+    }
+
+    for (auto& connection : connections)
+        disconnect (connection);
+}
+
+void SessionSocketServer::acceptConnections (std::vector<Connection>& connections)
+{
+    for (;;)
+    {
+        const auto socket = ::accept (listener, nullptr, nullptr);
+        if (socket < 0)
+            return;
+
+       #ifdef SO_NOSIGPIPE
+        const int yes = 1;
+        ::setsockopt (socket, SOL_SOCKET, SO_NOSIGPIPE, &yes, sizeof (yes));
+       #endif
+
+        setNonBlocking (socket);
+
+        Connection connection;
+        connection.socket = socket;
+        connection.sessionId = host.createSession (sessionSetup);
+        connections.push_back (std::move (connection));
+        ++numConnections;
+    }
+}
+
+bool SessionSocketServer::readFrom (Connection& connection)
+{
+    char buffer[4096];
+    const auto numRead = ::recv (connection.socket, buffer, sizeof (buffer), 0);
+
+    if (numRead < 0)
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+
+    if (numRead == 0)
+        return false; // The client hung up.
+
+    auto& line = connection.unfinishedLine;
+    const auto socket = connection.socket;
+
+    for (ssize_t i = 0; i < numRead; ++i)
+    {
+        const auto c = buffer[i];
+
+        if (connection.isSkippingLine)
+        {
+            connection.isSkippingLine = c != '\n';
+            continue;
+        }
+
+        if (c != '\n')
+        {
+            line.push_back (c);
+
+            if (line.size() < maxLineLength)
+                continue;
+
+            connection.isSkippingLine = true; // Posted once, as it is, to fail for being too long.
+        }
+        else if (! line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+
+        host.post (connection.sessionId, std::move (line), [socket] (SessionHost::SessionId, const Result& r)
+        {
+            writeLine (socket, r.wasOk() ? String ("ok") : "error: " + r.getErrorMessage());
+        });
+
+        line.clear();
+    }
+
+    return true;
+}
+
+void SessionSocketServer::disconnect (Connection& connection)
+{
+    // The socket is closed by the session's worker, once it's done replying to it.
+    const auto socket = connection.socket;
+    host.closeSession (connection.sessionId, [socket] { ::close (socket); });
+
+    connection.socket = -1;
+    --numConnections;
+}
+
+#endif
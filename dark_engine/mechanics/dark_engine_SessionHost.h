@@ -0,0 +1,157 @@
+//==============================================================================
+/** Runs many independent game sessions, each with its own GameProcessor,
+    UndoManager and world, across a fixed number of worker threads.
+
+    Every session belongs to a single worker for its whole life, picked from
+    its ID, so a session's commands are carried out in the order they were
+    posted and never on two threads at once, without locking the session.
+    Each worker has its own queue, so posting to sessions that live on
+    different workers never contends on a shared lock.
+
+    Creating and closing sessions goes through the same queues, so a command
+    posted right after createSession() is always carried out after the
+    session exists.
+
+    @see GameProcessor, SessionSocketServer
+*/
+class SessionHost final
+{
+public:
+    /** Identifies a session. Never 0. */
+    using SessionId = uint32;
+
+    /** Called on the session's worker, right after its GameProcessor was made,
+        like to register custom commands or load content.
+    */
+    using SessionSetup = std::function<void (GameProcessor&)>;
+
+    /** Called on the session's worker with the result of a posted command. */
+    using ReplyCallback = std::function<void (SessionId, const Result&)>;
+
+    /** @param numWorkers           The number of threads that carry out commands.
+        @param numPrefetchThreads   The number of threads, shared by every session,
+                                    that prefetch the maps linked to a session's current map.
+    */
+    explicit SessionHost (int numWorkers = SystemStats::getNumCpus(), int numPrefetchThreads = 1);
+
+    /** Stops the workers and destroys every session.
+        Commands that haven't been carried out yet are dropped without a reply.
+    */
+    ~SessionHost();
+
+    //==============================================================================
+    /** Creates a session on its worker.
+
+        @returns the new session's ID, which can be posted to straight away.
+    */
+    SessionId createSession (SessionSetup setup = nullptr);
+
+    /** Destroys the session once its worker has carried out the commands posted before this.
+
+        @param onClosed If not nullptr, called on the session's worker once the session is gone.
+    */
+    void closeSession (SessionId sessionId, std::function<void()> onClosed = nullptr);
+
+    /** Queues a command for the session, to be carried out on its worker.
+        Each command is a transaction of the session's UndoManager.
+
+        @param onReply If not nullptr, called on the session's worker with the command's result.
+    */
+    void post (SessionId sessionId, std::string command, ReplyCallback onReply = nullptr);
+
+    /** Blocks until every worker has carried out what had been queued when this was called. */
+    void waitUntilIdle();
+
+    //==============================================================================
+    /** @returns the number of sessions that currently exist. */
+    [[nodiscard]] int getNumSessions() const noexcept   { return numSessions.load (std::memory_order_relaxed); }
+    /** @returns */
+    [[nodiscard]] int getNumWorkers() const noexcept    { return workers.size(); }
+
+private:
+    //==============================================================================
+    struct Session;
+    struct Task;
+    class Worker;
+
+    ThreadPool prefetchPool;
+    OwnedArray<Worker> workers;
+    std::atomic<SessionId> nextSessionId { 1 };
+    std::atomic<int> numSessions { 0 };
+
+    //==============================================================================
+    [[nodiscard]] Worker& getWorker (SessionId sessionId) const noexcept;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SessionHost)
+};
+
+#if JUCE_LINUX || JUCE_MAC || JUCE_BSD
+
+//==============================================================================
+/** Lets clients play sessions of a SessionHost over a Unix-domain socket.
+
+    Each connection gets its own session, which is closed when the client
+    disconnects. The protocol is line based: every line that the client sends
+    is a command, and every command is answered with a line, in order,
+    of either "ok" or "error: " followed by the message.
+    A line that's too long is answered with a single error.
+
+    All connections are read by a single thread that polls them,
+    so an idle client costs a file descriptor rather than a thread.
+    Replies are written by the sessions' workers, and a client that stops
+    reading them for longer than sendTimeoutMs is disconnected.
+
+    @see SessionHost
+*/
+class SessionSocketServer final : private Thread
+{
+public:
+    /** @param setup Called for the session of every new connection. */
+    SessionSocketServer (SessionHost& hostToUse, SessionHost::SessionSetup setup = nullptr);
+
+    /** */
+    ~SessionSocketServer() override;
+
+    //==============================================================================
+    /** Starts listening on the socket file, replacing any file that's already there. */
+    [[nodiscard]] Result start (const File& socketFileToUse);
+
+    /** How long a reply may wait for the client to make room for it, in milliseconds. */
+    static constexpr int sendTimeoutMs = 5000;
+
+    /** Disconnects every client, closes their sessions and removes the socket file. */
+    void stop();
+
+    /** @returns */
+    [[nodiscard]] bool isListening() const              { return isThreadRunning(); }
+    /** @returns the number of clients that are connected. */
+    [[nodiscard]] int getNumConnections() const noexcept { return numConnections.load (std::memory_order_relaxed); }
+
+private:
+    //==============================================================================
+    struct Connection final
+    {
+        int socket = -1;
+        SessionHost::SessionId sessionId = 0;
+        std::string unfinishedLine;
+        bool isSkippingLine = false; // After a line that's too long, until its end.
+    };
+
+    SessionHost& host;
+    const SessionHost::SessionSetup sessionSetup;
+    File socketFile;
+    int listener = -1;
+    std::atomic<int> numConnections { 0 };
+
+    //==============================================================================
+    void run() override;
+    void acceptConnections (std::vector<Connection>&);
+    bool readFrom (Connection&);
+    void disconnect (Connection&);
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SessionSocketServer)
+};
+
+#endif
@@ -0,0 +1,162 @@
+//==============================================================================
+StatusEngine::TickSummary StatusEngine::tick (const GameMap& map, Random& random, UndoManager* undoManager)
+{
+    gather (map);
+
+    draws.resize (states.size());
+    for (auto& d : draws)
+        d = (uint64) random.nextInt64();
+
+    applyDamage();
+    applyExpiry();
+    applySkipTurn();
+
+    return writeBack (undoManager);
+}
+
+//==============================================================================
+void StatusEngine::gather (const GameMap& map)
+{
+    states.clear();
+    flags.clear();
+    hitPoints.clear();
+    maxHitPoints.clear();
+    prototypes.clear();
+
+    const auto& index = map.getStatusIndex();
+
+    for (const auto& child : index.getAfflictedObjects())
+    {
+        const auto statusFlags = index.getStatusFlags (child);
+        if (statusFlags == 0)
+            continue;
+
+        const FightableEntityView view (child, findPrototype (map, child));
+        const auto hp = view.getHitPoints();
+
+        if (hp <= 0)
+            continue; // Fainted already.
+
+        states.push_back (child);
+        flags.push_back (statusFlags);
+        hitPoints.push_back (hp);
+        maxHitPoints.push_back (view.getMaxHitPoints());
+    }
+
+    const auto numAfflicted = states.size();
+    newFlags.resize (numAfflicted);
+    newHitPoints.resize (numAfflicted);
+    skipsTurn.resize (numAfflicted);
+}
+
+ValueTree StatusEngine::findPrototype (const GameMap& map, const ValueTree& state)
+{
+    const auto* name = state.getPropertyPointer (prototypeId);
+    if (name == nullptr)
+        return {};
+
+    const auto definitionName = name->toString();
+
+    if (prototypes.contains (definitionName))
+        return prototypes[definitionName];
+
+    auto definition = map.findDefinition (definitionName);
+    prototypes.set (definitionName, definition);
+    return definition;
+}
+
+//==============================================================================
+void StatusEngine::applyDamage()
+{
+    const auto num = states.size();
+    auto* f = flags.data();
+    auto* maxHp = maxHitPoints.data();
+    auto* hp = newHitPoints.data();
+
+    std::copy (hitPoints.begin(), hitPoints.end(), newHitPoints.begin());
+
+    for (const auto& rule : damageRules)
+        for (size_t i = 0; i < num; ++i)
+            hp[i] -= (f[i] & rule.flag) != 0 ? jmax (1, maxHp[i] >> rule.shift) : 0;
+
+    for (size_t i = 0; i < num; ++i)
+        hp[i] = jmax (0, hp[i]);
+}
+
+void StatusEngine::applyExpiry()
+{
+    const auto num = states.size();
+    const auto* d = draws.data();
+    const auto* hp = newHitPoints.data();
+    auto* f = newFlags.data();
+
+    std::copy (flags.begin(), flags.end(), newFlags.begin());
+
+    int shift = 0;
+
+    for (const auto& rule : expiryRules)
+    {
+        for (size_t i = 0; i < num; ++i)
+            f[i] &= (int) ((d[i] >> shift) & 0xff) < rule.chance ? ~rule.flag : ~0;
+
+        shift += 8;
+    }
+
+    // Fainting clears everything:
+    for (size_t i = 0; i < num; ++i)
+        f[i] = hp[i] > 0 ? f[i] : 0;
+}
+
+void StatusEngine::applySkipTurn()
+{
+    const auto num = states.size();
+    const auto* d = draws.data();
+    const auto* f = newFlags.data();
+    auto* skips = skipsTurn.data();
+
+    for (size_t i = 0; i < num; ++i)
+        skips[i] = (f[i] & alwaysSkipTurnFlags) != 0 ? 1 : 0;
+
+    int shift = 8 * (int) std::size (expiryRules);
+
+    for (const auto& rule : skipTurnRules)
+    {
+        for (size_t i = 0; i < num; ++i)
+            skips[i] |= (f[i] & rule.flag) != 0 && (int) ((d[i] >> shift) & 0xff) < rule.chance ? 1 : 0;
+
+        shift += 8;
+    }
+}
+
+StatusEngine::TickSummary StatusEngine::writeBack (UndoManager* undoManager)
+{
+    TickSummary summary;
+    summary.numAfflicted = (int) states.size();
+
+    skippingTurn.clearQuick();
+
+    for (size_t i = 0; i < states.size(); ++i)
+    {
+        auto& state = states[i];
+        const auto flagsChanged = newFlags[i] != flags[i];
+        const auto hitPointsChanged = newHitPoints[i] != hitPoints[i];
+
+        if (flagsChanged)
+            state.setProperty (statusConditionId, newFlags[i], undoManager);
+
+        if (hitPointsChanged)
+            state.setProperty (hitPointsId, newHitPoints[i], undoManager);
+
+        if (flagsChanged || hitPointsChanged)
+            ++summary.numChanged;
+
+        if (newHitPoints[i] == 0)
+            ++summary.numFainted;
+
+        if (skipsTurn[i] != 0)
+            skippingTurn.add (state);
+    }
+
+    states.clear(); // Let go of the objects, without letting go of the storage.
+    return summary;
+}
@@ -0,0 +1,129 @@
+//==============================================================================
+/** Applies the effects of every StatusCondition in a map's world, once per tick.
+
+    Each tick, the status condition, hit points and max hit points of every
+    afflicted object (ie: any direct child of the world whose StatusCondition
+    isn't normal, like a FightableEntity) are gathered into plain arrays, one
+    per field. The afflicted objects come from the map's StatusIndex, so the
+    rest of the world isn't even looked at. Each rule is then a single loop
+    over those arrays, without any branching per object, so that the compiler
+    can vectorise it. Only the objects that were actually changed are written
+    back to their states.
+
+    The rules are, in order:
+    - Damage over time: being burned, poisoned, frostbitten, bound or cursed
+      each costs a fraction of the max hit points (at least 1), all added up.
+    - Expiry: being frozen, asleep, drowsy or bound each has a chance of wearing off.
+      The other conditions last until they're cured.
+    - Skipping a turn: being frozen, asleep or bound always costs the turn,
+      whereas being paralysed or drowsy only sometimes does.
+    - Fainting: an object that drops to 0 hit points loses all of its conditions.
+
+    Objects that have already fainted are left alone.
+
+    The chances are drawn from the given Random, one draw per afflicted object
+    in the StatusIndex's order, so a tick is as deterministic as the random number generator.
+
+    @see StatusCondition, FightableEntity, GameProcessor::advanceTick
+*/
+class StatusEngine final
+{
+public:
+    /** */
+    StatusEngine() = default;
+
+    //==============================================================================
+    /** What a tick did. */
+    struct TickSummary final
+    {
+        int numAfflicted = 0;   // The number of objects that had any conditions.
+        int numChanged = 0;     // The number of objects whose state was written to.
+        int numFainted = 0;     // The number of objects that fainted from their conditions.
+    };
+
+    /** Applies one tick's worth of status effects to every afflicted object in the map's world.
+
+        The arrays are kept from one tick to the next, so they only grow
+        when more objects are afflicted than ever before.
+
+        @param undoManager  Only pass one to make the tick's changes undoable on purpose,
+                            like in an editor. A game shouldn't: the changes would get
+                            folded into the player's next undoable command.
+    */
+    TickSummary tick (const GameMap& map, Random& random, UndoManager* undoManager = nullptr);
+
+    /** @returns the objects that lose their turn because of their conditions,
+        as of the last tick, in the StatusIndex's order.
+    */
+    [[nodiscard]] const Array<ValueTree>& getObjectsSkippingTurn() const noexcept  { return skippingTurn; }
+
+    /** @returns true if the object lost its turn because of its conditions, as of the last tick. */
+    [[nodiscard]] bool isSkippingTurn (const ValueTree& state) const noexcept      { return skippingTurn.contains (state); }
+
+    //==============================================================================
+    /** A condition that costs its max hit points shifted right by this much, every tick. */
+    struct DamageRule final
+    {
+        int flag = 0, shift = 0;
+    };
+
+    /** A condition that something happens to with a chance out of 256, every tick. */
+    struct ChanceRule final
+    {
+        int flag = 0, chance = 0;
+    };
+
+    /** */
+    static constexpr DamageRule damageRules[] =
+    {
+        { StatusCondition::burned,      4 },    // 1/16
+        { StatusCondition::poisoned,    3 },    // 1/8
+        { StatusCondition::frostbitten, 4 },    // 1/16
+        { StatusCondition::bound,       4 },    // 1/16
+        { StatusCondition::cursed,      2 }     // 1/4
+    };
+
+    /** */
+    static constexpr ChanceRule expiryRules[] =
+    {
+        { StatusCondition::frozen,      51 },   // 20%
+        { StatusCondition::asleep,      85 },   // 33%
+        { StatusCondition::drowsy,      64 },   // 25%
+        { StatusCondition::bound,       64 }    // 25%
+    };
+
+    /** */
+    static constexpr ChanceRule skipTurnRules[] =
+    {
+        { StatusCondition::paralysed,   64 },   // 25%
+        { StatusCondition::drowsy,      85 }    // 33%
+    };
+
+    /** The conditions that always cost the turn. */
+    static constexpr int alwaysSkipTurnFlags = StatusCondition::frozen | StatusCondition::asleep | StatusCondition::bound;
+
+private:
+    //==============================================================================
+    // Each chance rule reads its own byte of a lane's 64-bit draw:
+    static_assert (std::size (expiryRules) + std::size (skipTurnRules) <= sizeof (uint64));
+
+    // One entry per afflicted object, in the StatusIndex's order:
+    std::vector<ValueTree> states;
+    std::vector<int32> flags, hitPoints, maxHitPoints, newFlags, newHitPoints, skipsTurn;
+    std::vector<uint64> draws;
+
+    Array<ValueTree> skippingTurn;
+    HashMap<String, ValueTree> prototypes; // Only for the duration of a tick.
+
+    //==============================================================================
+    void gather (const GameMap&);
+    void applyDamage();
+    void applyExpiry();
+    void applySkipTurn();
+    TickSummary writeBack (UndoManager*);
+
+    [[nodiscard]] ValueTree findPrototype (const GameMap&, const ValueTree& state);
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StatusEngine)
+};
@@ -0,0 +1,293 @@
+//==============================================================================
+/** Orders the actions of a battle's combatants: the highest priority move first,
+    then the fastest combatant, then the one that ranks first for ties.
+
+    Queued actions are kept in a binary heap that knows where each combatant
+    sits in it, so queueing, cancelling and taking the next action, as well as
+    changing a combatant's speed mid-turn (eg: by being paralysed), each only
+    moves that one combatant up or down the heap, rather than sorting everyone
+    again.
+
+    Ties are broken by the order the combatants were added in, unless they're
+    shuffled with a Random, so the order is always reproducible.
+
+    @code
+        TurnScheduler scheduler;
+        const auto hero = scheduler.addCombatant (TurnScheduler::getEffectiveSpeed (heroView));
+        const auto slime = scheduler.addCombatant (TurnScheduler::getEffectiveSpeed (slimeView));
+
+        scheduler.queueAction (hero, heroMove.getPriority());
+        scheduler.queueAction (slime, slimeMove.getPriority());
+
+        for (auto next = scheduler.popNext(); next >= 0; next = scheduler.popNext())
+            ...
+    @endcode
+
+    @see FightableEntity, FightingMove, StatusEngine
+*/
+class TurnScheduler final
+{
+public:
+    /** */
+    TurnScheduler() = default;
+
+    /** Identifies a combatant. Never negative. */
+    using Handle = int;
+
+    //==============================================================================
+    /** @returns the speed that a combatant acts with: its speed, scaled by its nature,
+        and halved if it's paralysed.
+    */
+    [[nodiscard]] static int getEffectiveSpeed (const FightableEntityView& view)
+    {
+        const auto speed = CombatTables::applyNature (view.getSpeed(), view.getNature(), Stat::speed);
+        return view.getStatusCondition().isParalysed() ? speed / 2 : speed;
+    }
+
+    //==============================================================================
+    /** Adds a combatant, which ranks after every other one for ties.
+        @returns the combatant's handle, which may be one that was removed before.
+    */
+    Handle addCombatant (int speed)
+    {
+        Handle handle;
+
+        if (! freeHandles.empty())
+        {
+            handle = freeHandles.back();
+            freeHandles.pop_back();
+        }
+        else
+        {
+            handle = (Handle) combatants.size();
+            combatants.emplace_back();
+        }
+
+        auto& c = combatants[(size_t) handle];
+        c = {};
+        c.speed = speed;
+        c.tieBreak = nextTieBreak++;
+        c.isActive = true;
+        return handle;
+    }
+
+    /** Removes a combatant, along with any action it had queued. */
+    void removeCombatant (Handle handle)
+    {
+        if (! isActive (handle))
+            return;
+
+        cancelAction (handle);
+        combatants[(size_t) handle].isActive = false;
+        freeHandles.push_back (handle);
+    }
+
+    /** Removes every combatant and action. */
+    void clear() noexcept
+    {
+        combatants.clear();
+        freeHandles.clear();
+        heap.clear();
+        nextTieBreak = 0;
+    }
+
+    /** @returns */
+    [[nodiscard]] bool isActive (Handle handle) const noexcept
+    {
+        return isPositiveAndBelow (handle, (int) combatants.size()) && combatants[(size_t) handle].isActive;
+    }
+
+    //==============================================================================
+    /** Changes a combatant's speed, moving its queued action, if any, to where it now belongs. */
+    void setSpeed (Handle handle, int newSpeed)
+    {
+        if (! isActive (handle))
+            return;
+
+        auto& c = combatants[(size_t) handle];
+        const auto oldSpeed = std::exchange (c.speed, newSpeed);
+
+        if (c.heapIndex >= 0 && oldSpeed != newSpeed)
+            reposition (c.heapIndex);
+    }
+
+    /** @returns */
+    [[nodiscard]] int getSpeed (Handle handle) const noexcept
+    {
+        return isActive (handle) ? combatants[(size_t) handle].speed : 0;
+    }
+
+    /** Gives every combatant a new place for breaking ties, drawn from the random number generator.
+        Only draws in the order of the handles, so it's as reproducible as the generator.
+    */
+    void shuffleTieBreaks (Random& random)
+    {
+        for (auto& c : combatants)
+            if (c.isActive)
+                c.tieBreak = random.nextInt();
+
+        for (auto i = (int) heap.size() / 2; --i >= 0;)
+            siftDown (i);
+    }
+
+    //==============================================================================
+    /** Queues a combatant's action for this turn, or moves it if it had one queued already.
+        @param priority The priority of the move being used. @see FightingMove::getPriority
+    */
+    void queueAction (Handle handle, int priority)
+    {
+        if (! isActive (handle))
+            return;
+
+        auto& c = combatants[(size_t) handle];
+        c.priority = priority;
+
+        if (c.heapIndex >= 0)
+        {
+            reposition (c.heapIndex);
+            return;
+        }
+
+        c.heapIndex = (int) heap.size();
+        heap.push_back (handle);
+        siftUp (c.heapIndex);
+    }
+
+    /** Drops a combatant's queued action, like when it faints or loses its turn. */
+    void cancelAction (Handle handle)
+    {
+        if (! isActive (handle))
+            return;
+
+        const auto index = combatants[(size_t) handle].heapIndex;
+
+        if (index >= 0)
+            removeAt (index);
+    }
+
+    /** @returns true if the combatant has an action waiting. */
+    [[nodiscard]] bool hasQueuedAction (Handle handle) const noexcept
+    {
+        return isActive (handle) && combatants[(size_t) handle].heapIndex >= 0;
+    }
+
+    /** @returns the combatant that acts next, without taking its action, or -1 if none are queued. */
+    [[nodiscard]] Handle peekNext() const noexcept      { return heap.empty() ? -1 : heap.front(); }
+
+    /** Takes the next action.
+        @returns the combatant that acts, or -1 if none are queued.
+    */
+    Handle popNext()
+    {
+        if (heap.empty())
+            return -1;
+
+        const auto handle = heap.front();
+        removeAt (0);
+        return handle;
+    }
+
+    /** @returns the number of actions waiting. */
+    [[nodiscard]] int getNumQueued() const noexcept     { return (int) heap.size(); }
+
+private:
+    //==============================================================================
+    struct Combatant final
+    {
+        int speed = 0, priority = 0, tieBreak = 0;
+        int heapIndex = -1;  // -1 if nothing is queued.
+        bool isActive = false;
+    };
+
+    std::vector<Combatant> combatants;  // Indexed by handle.
+    std::vector<Handle> freeHandles;
+    std::vector<Handle> heap;           // The next to act is at the front.
+    int nextTieBreak = 0;
+
+    //==============================================================================
+    /** @returns true if the first should act before the second. */
+    [[nodiscard]] bool actsBefore (Handle a, Handle b) const noexcept
+    {
+        const auto& ca = combatants[(size_t) a];
+        const auto& cb = combatants[(size_t) b];
+
+        if (ca.priority != cb.priority) return ca.priority > cb.priority;
+        if (ca.speed != cb.speed)       return ca.speed > cb.speed;
+        if (ca.tieBreak != cb.tieBreak) return ca.tieBreak < cb.tieBreak;
+        return a < b;
+    }
+
+    void place (int index, Handle handle) noexcept
+    {
+        heap[(size_t) index] = handle;
+        combatants[(size_t) handle].heapIndex = index;
+    }
+
+    void siftUp (int index) noexcept
+    {
+        const auto handle = heap[(size_t) index];
+
+        while (index > 0)
+        {
+            const auto parent = (index - 1) / 2;
+
+            if (! actsBefore (handle, heap[(size_t) parent]))
+                break;
+
+            place (index, heap[(size_t) parent]);
+            index = parent;
+        }
+
+        place (index, handle);
+    }
+
+    void siftDown (int index) noexcept
+    {
+        const auto size = (int) heap.size();
+        const auto handle = heap[(size_t) index];
+
+        for (;;)
+        {
+            auto best = index * 2 + 1;
+
+            if (best >= size)
+                break;
+
+            if (best + 1 < size && actsBefore (heap[(size_t) best + 1], heap[(size_t) best]))
+                ++best;
+
+            if (! actsBefore (heap[(size_t) best], handle))
+                break;
+
+            place (index, heap[(size_t) best]);
+            index = best;
+        }
+
+        place (index, handle);
+    }
+
+    void reposition (int index) noexcept
+    {
+        const auto handle = heap[(size_t) index];
+        siftUp (index);
+        siftDown (combatants[(size_t) handle].heapIndex);
+    }
+
+    void removeAt (int index)
+    {
+        const auto removed = heap[(size_t) index];
+        const auto last = heap.back();
+        heap.pop_back();
+
+        combatants[(size_t) removed].heapIndex = -1;
+
+        if (last == removed)
+            return;
+
+        place (index, last);
+        reposition (index);
+    }
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TurnScheduler)
+};
@@ -0,0 +1,346 @@
+//==============================================================================
+/** Owns the GameMaps of a world, one per room or environment, addressed by name.
+
+    Maps are loaded on demand as the player moves between them through
+    DoorTiles and StairTiles, and the maps that the current map links to are
+    prefetched on a background thread so that crossing over doesn't stall.
+
+    Whenever the estimated memory of the loaded maps goes over the budget,
+    the least recently used maps are evicted, so memory stays flat
+    regardless of how many maps the world is made of.
+    The current map is never evicted.
+
+    The loader is called from both the calling thread and the prefetching
+    thread, so it must be thread-safe and shouldn't give the maps it creates
+    an UndoManager.
+
+    Many WorldManagers can share a prefetching pool (eg: one per SessionHost),
+    so that running many worlds at once doesn't cost a thread per world.
+
+    @see GameMap, MapLink, GameProcessor
+*/
+class WorldManager final
+{
+public:
+    /** Creates the named map, or returns nullptr if there's no such map. */
+    using MapLoader = std::function<std::unique_ptr<GameMap> (const String& mapName)>;
+
+    /** */
+    static constexpr size_t defaultMemoryBudget = 64 * 1024 * 1024;
+
+    /** @param sharedPrefetchPool If not nullptr, maps are prefetched on this pool,
+                                  which must outlive the WorldManager.
+                                  Otherwise the WorldManager makes its own single thread pool.
+    */
+    WorldManager (Player& playerToUse, MapLoader loaderToUse,
+                  size_t memoryBudgetInBytes = defaultMemoryBudget,
+                  ThreadPool* sharedPrefetchPool = nullptr) :
+        player (playerToUse),
+        loader (std::move (loaderToUse)),
+        memoryBudget (memoryBudgetInBytes),
+        prefetchPool (sharedPrefetchPool != nullptr ? sharedPrefetchPool : new ThreadPool (1),
+                      sharedPrefetchPool == nullptr)
+    {
+        jassert (loader != nullptr);
+    }
+
+    /** */
+    ~WorldManager()
+    {
+        // Only this manager's jobs, since the pool may be shared:
+        for (auto* job : prefetchJobs)
+            prefetchPool->removeJob (job, true, -1);
+
+        if (current != nullptr)
+            current->map->detachPlayer();
+    }
+
+    //==============================================================================
+    /** Called on the thread that called enterMap(), once the player is on the map,
+        like for a UI to switch over to it.
+
+        This is called before any cold maps are evicted, so it's the last chance
+        to let go of the previous map: it mustn't be used once this returns.
+    */
+    std::function<void (GameMap&)> onMapEntered;
+
+    /** Moves the player onto the named map at the position, loading the map if need be,
+        then starts prefetching the maps it links to, calls onMapEntered and evicts any cold maps.
+
+        @returns the entered map, or nullptr if it couldn't be loaded,
+                 in which case the player stays where it was.
+    */
+    GameMap* enterMap (const String& mapName, Point<int> position)
+    {
+        collectPrefetchedMaps();
+
+        auto* entry = findOrLoad (mapName);
+        if (entry == nullptr)
+            return nullptr;
+
+        if (current != nullptr)
+        {
+            current->map->detachPlayer();
+            current->memoryUsage = current->map->getEstimatedMemoryUsage();
+        }
+
+        current = entry;
+        touch (*current);
+        current->map->attachPlayer (player, position);
+
+        prefetchLinkedMaps (*current->map);
+
+        if (onMapEntered != nullptr)
+            onMapEntered (*current->map);
+
+        evictColdMaps();
+        return current->map.get();
+    }
+
+    /** Moves the player through a DoorTile or StairTile, given its state.
+
+        @returns the entered map, or nullptr if the tile isn't linked
+                 or its map couldn't be loaded.
+
+        @see MapLink
+    */
+    GameMap* followLink (const ValueTree& linkedTileState)
+    {
+        if (! MapLink::hasDestination (linkedTileState))
+            return nullptr;
+
+        return enterMap (MapLink::getDestinationMap (linkedTileState),
+                         MapLink::getDestinationPosition (linkedTileState));
+    }
+
+    /** Adopts any maps that finished prefetching, evicting cold maps if that goes over budget.
+        Call this regularly, like once per game tick: it's cheap when no prefetch has finished.
+
+        Measuring a map walks its whole state, so the current map is only measured
+        when it's entered and left, or when the budget changes, never here.
+    */
+    void update()
+    {
+        if (collectPrefetchedMaps() > 0)
+            evictColdMaps();
+    }
+
+    //==============================================================================
+    /** @returns the map the player is on, or nullptr if no map has been entered yet. */
+    [[nodiscard]] GameMap* getCurrentMap() const noexcept   { return current != nullptr ? current->map.get() : nullptr; }
+    /** @returns */
+    [[nodiscard]] String getCurrentMapName() const          { return current != nullptr ? current->name : String(); }
+
+    /** @returns the named map, loading it if need be, or nullptr if it couldn't be loaded.
+        The map stays valid until the next call to enterMap(), update() or setMemoryBudget().
+    */
+    [[nodiscard]] GameMap* getMap (const String& mapName)
+    {
+        collectPrefetchedMaps();
+
+        if (auto* entry = findOrLoad (mapName))
+        {
+            touch (*entry);
+            return entry->map.get();
+        }
+
+        return nullptr;
+    }
+
+    /** @returns true if the named map is loaded, not counting maps still being prefetched. */
+    [[nodiscard]] bool isMapLoaded (const String& mapName) const    { return findEntry (mapName) != nullptr; }
+    /** @returns */
+    [[nodiscard]] int getNumLoadedMaps() const noexcept             { return entries.size(); }
+
+    //==============================================================================
+    /** Changes the memory budget, evicting cold maps if the loaded maps go over it. */
+    void setMemoryBudget (size_t newBudgetInBytes)
+    {
+        memoryBudget = newBudgetInBytes;
+
+        if (current != nullptr)
+            current->memoryUsage = current->map->getEstimatedMemoryUsage();
+
+        evictColdMaps();
+    }
+
+    /** @returns */
+    [[nodiscard]] size_t getMemoryBudget() const noexcept   { return memoryBudget; }
+
+    /** @returns the estimated memory of the loaded maps, as of when they were last measured. */
+    [[nodiscard]] size_t getMemoryUsage() const noexcept
+    {
+        size_t total = 0;
+
+        for (const auto* entry : entries)
+            total += entry->memoryUsage;
+
+        return total;
+    }
+
+    //==============================================================================
+    /** Called with a map right before it's evicted, like to save its state
+        so that the loader can bring the map back as it was left.
+        This may be called from enterMap(), update() and setMemoryBudget().
+    */
+    std::function<void (const String& mapName, GameMap&)> onMapEvicted;
+
+private:
+    //==============================================================================
+    struct Entry final
+    {
+        String name;
+        std::unique_ptr<GameMap> map;
+        size_t memoryUsage = 0;
+        uint64 lastUsed = 0;
+    };
+
+    /** Loads a map on the prefetching thread.
+        The result is only touched by the owner once the pool no longer contains the job.
+    */
+    struct PrefetchJob final : public ThreadPoolJob
+    {
+        PrefetchJob (const MapLoader& l, const String& n) :
+            ThreadPoolJob ("Prefetch " + n),
+            loader (l),
+            mapName (n)
+        {
+        }
+
+        JobStatus runJob() override
+        {
+            result = loader (mapName);
+            return jobHasFinished;
+        }
+
+        const MapLoader& loader;
+        const String mapName;
+        std::unique_ptr<GameMap> result;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PrefetchJob)
+    };
+
+    //==============================================================================
+    Player& player;
+    const MapLoader loader;
+    size_t memoryBudget;
+
+    OwnedArray<Entry> entries;
+    Entry* current = nullptr;
+    uint64 clock = 0;
+
+    OwnedArray<PrefetchJob> prefetchJobs;
+    OptionalScopedPointer<ThreadPool> prefetchPool;
+
+    //==============================================================================
+    void touch (Entry& entry) noexcept  { entry.lastUsed = ++clock; }
+
+    [[nodiscard]] Entry* findEntry (const String& mapName) const
+    {
+        for (auto* entry : entries)
+            if (entry->name == mapName)
+                return entry;
+
+        return nullptr;
+    }
+
+    [[nodiscard]] PrefetchJob* findPrefetchJob (const String& mapName) const
+    {
+        for (auto* job : prefetchJobs)
+            if (job->mapName == mapName)
+                return job;
+
+        return nullptr;
+    }
+
+    Entry* addEntry (const String& mapName, std::unique_ptr<GameMap> map)
+    {
+        if (map == nullptr)
+            return nullptr;
+
+        auto* entry = entries.add (new Entry());
+        entry->name = mapName;
+        entry->memoryUsage = map->getEstimatedMemoryUsage();
+        entry->map = std::move (map);
+        touch (*entry);
+        return entry;
+    }
+
+    /** Uses a loaded or prefetched map if there is one, waiting for its prefetch
+        to finish if need be, and otherwise loads the map on this thread.
+    */
+    Entry* findOrLoad (const String& mapName)
+    {
+        if (auto* entry = findEntry (mapName))
+            return entry;
+
+        if (auto* job = findPrefetchJob (mapName))
+        {
+            prefetchPool->waitForJobToFinish (job, -1);
+            auto map = std::move (job->result);
+            prefetchJobs.removeObject (job);
+            return addEntry (mapName, std::move (map));
+        }
+
+        return addEntry (mapName, loader (mapName));
+    }
+
+    void prefetchLinkedMaps (const GameMap& map)
+    {
+        for (const auto& name : map.getLinkedMapNames())
+        {
+            if (findEntry (name) == nullptr && findPrefetchJob (name) == nullptr)
+            {
+                auto* job = prefetchJobs.add (new PrefetchJob (loader, name));
+                prefetchPool->addJob (job, false);
+            }
+        }
+    }
+
+    /** @returns the number of prefetches that finished. */
+    int collectPrefetchedMaps()
+    {
+        int numCollected = 0;
+
+        for (int i = prefetchJobs.size(); --i >= 0;)
+        {
+            auto* job = prefetchJobs.getUnchecked (i);
+
+            if (! prefetchPool->contains (job))
+            {
+                addEntry (job->mapName, std::move (job->result));
+                prefetchJobs.remove (i);
+                ++numCollected;
+            }
+        }
+
+        return numCollected;
+    }
+
+    void evictColdMaps()
+    {
+        auto usage = getMemoryUsage();
+
+        while (usage > memoryBudget)
+        {
+            Entry* coldest = nullptr;
+
+            for (auto* entry : entries)
+                if (entry != current && (coldest == nullptr || entry->lastUsed < coldest->lastUsed))
+                    coldest = entry;
+
+            if (coldest == nullptr)
+                break;
+
+            usage -= coldest->memoryUsage;
+
+            if (onMapEvicted != nullptr)
+                onMapEvicted (coldest->name, *coldest->map);
+
+            entries.removeObject (coldest);
+        }
+    }
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WorldManager)
+};
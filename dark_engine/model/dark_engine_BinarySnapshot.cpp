@@ -0,0 +1,432 @@
+namespace
+{
+    enum class SnapshotTag : uint8
+    {
+        voidValue,
+        falseValue,
+        trueValue,
+        intValue,
+        int64Value,
+        doubleValue,
+        stringValue,
+        arrayValue,
+        binaryValue
+    };
+
+    constexpr char snapshotMagic[] = { 'D', 'k', 'S', 'n' };
+
+    /** Guards against malformed files exhausting the stack. */
+    constexpr int maxSnapshotDepth = 512;
+
+    constexpr uint64 toZigzag (int64 v) noexcept     { return (static_cast<uint64> (v) << 1) ^ static_cast<uint64> (v >> 63); }
+    constexpr int64 fromZigzag (uint64 v) noexcept   { return static_cast<int64> ((v >> 1) ^ (0 - (v & 1))); }
+
+    //==============================================================================
+    struct SnapshotWriter final
+    {
+        explicit SnapshotWriter (OutputStream& o) :
+            output (o)
+        {
+        }
+
+        void write (const ValueTree& root)
+        {
+            collectIdentifiers (root);
+
+            output.write (snapshotMagic, sizeof (snapshotMagic));
+            output.writeShort (static_cast<short> (BinarySnapshot::currentVersion));
+
+            writeVarint (static_cast<uint64> (identifiers.size()));
+
+            for (const auto& id : identifiers)
+                writeString (id.toString());
+
+            writeNode (root);
+        }
+
+    private:
+        OutputStream& output;
+        Array<Identifier> identifiers;
+        std::unordered_map<const void*, uint64> indices; // Identifiers are pooled, so their text's address is unique.
+
+        void collectIdentifiers (const ValueTree& tree)
+        {
+            intern (tree.getType());
+
+            for (int i = 0; i < tree.getNumProperties(); ++i)
+                intern (tree.getPropertyName (i));
+
+            for (const auto& child : tree)
+                collectIdentifiers (child);
+        }
+
+        void intern (const Identifier& id)
+        {
+            if (indices.try_emplace (id.getCharPointer().getAddress(), static_cast<uint64> (identifiers.size())).second)
+                identifiers.add (id);
+        }
+
+        uint64 indexOf (const Identifier& id) const
+        {
+            return indices.at (id.getCharPointer().getAddress());
+        }
+
+        void writeVarint (uint64 v)
+        {
+            uint8 buffer[10];
+            size_t numBytes = 0;
+
+            do
+            {
+                auto byte = static_cast<uint8> (v & 0x7f);
+                v >>= 7;
+
+                if (v != 0)
+                    byte |= 0x80;
+
+                buffer[numBytes++] = byte;
+            }
+            while (v != 0);
+
+            output.write (buffer, numBytes);
+        }
+
+        void writeTag (SnapshotTag tag)
+        {
+            output.writeByte (static_cast<char> (tag));
+        }
+
+        void writeString (const String& s)
+        {
+            const auto utf8 = s.toUTF8();
+            const auto numBytes = utf8.sizeInBytes() - 1;
+
+            writeVarint (static_cast<uint64> (numBytes));
+            output.write (utf8.getAddress(), numBytes);
+        }
+
+        void writeNode (const ValueTree& tree)
+        {
+            writeVarint (indexOf (tree.getType()));
+
+            const auto numProperties = tree.getNumProperties();
+            writeVarint (static_cast<uint64> (numProperties));
+
+            for (int i = 0; i < numProperties; ++i)
+            {
+                const auto name = tree.getPropertyName (i);
+                writeVarint (indexOf (name));
+                writeValue (tree.getProperty (name));
+            }
+
+            writeVarint (static_cast<uint64> (tree.getNumChildren()));
+
+            for (const auto& child : tree)
+                writeNode (child);
+        }
+
+        void writeValue (const var& v)
+        {
+            if (v.isBool())
+            {
+                writeTag (static_cast<bool> (v) ? SnapshotTag::trueValue : SnapshotTag::falseValue);
+            }
+            else if (v.isInt())
+            {
+                writeTag (SnapshotTag::intValue);
+                writeVarint (toZigzag (static_cast<int> (v)));
+            }
+            else if (v.isInt64())
+            {
+                writeTag (SnapshotTag::int64Value);
+                writeVarint (toZigzag (static_cast<int64> (v)));
+            }
+            else if (v.isDouble())
+            {
+                writeTag (SnapshotTag::doubleValue);
+                output.writeDouble (static_cast<double> (v));
+            }
+            else if (v.isString())
+            {
+                writeTag (SnapshotTag::stringValue);
+                writeString (v.toString());
+            }
+            else if (const auto* array = v.getArray())
+            {
+                writeTag (SnapshotTag::arrayValue);
+                writeVarint (static_cast<uint64> (array->size()));
+
+                for (const auto& element : *array)
+                    writeValue (element);
+            }
+            else if (const auto* block = v.getBinaryData())
+            {
+                writeTag (SnapshotTag::binaryValue);
+                writeVarint (static_cast<uint64> (block->getSize()));
+                output.write (block->getData(), block->getSize());
+            }
+            else
+            {
+                // Objects and methods can't be saved, so they're written as void:
+                jassert (v.isVoid() || v.isUndefined());
+                writeTag (SnapshotTag::voidValue);
+            }
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (SnapshotWriter)
+    };
+
+    //==============================================================================
+    /** Decodes a snapshot in place, bounds checking every read so that a
+        truncated or corrupt snapshot fails cleanly instead of reading past the end.
+    */
+    struct SnapshotReader final
+    {
+        SnapshotReader (const void* data, size_t numBytes) noexcept :
+            pos (static_cast<const uint8*> (data)),
+            end (pos + numBytes)
+        {
+        }
+
+        ValueTree read()
+        {
+            if (remaining() < sizeof (snapshotMagic) + 2
+                || std::memcmp (pos, snapshotMagic, sizeof (snapshotMagic)) != 0)
+                return {};
+
+            pos += sizeof (snapshotMagic);
+
+            const auto version = static_cast<int> (ByteOrder::littleEndianShort (pos));
+            pos += 2;
+
+            if (version <= 0 || version > BinarySnapshot::currentVersion)
+                return {};
+
+            const auto numIdentifiers = readVarint();
+            if (failed || numIdentifiers > remaining())
+                return {};
+
+            identifiers.ensureStorageAllocated (static_cast<int> (numIdentifiers));
+
+            for (uint64 i = 0; i < numIdentifiers; ++i)
+            {
+                const auto text = readString();
+                if (failed || text.isEmpty())
+                    return {};
+
+                identifiers.add (Identifier (text));
+            }
+
+            auto root = readNode (0);
+            return failed ? ValueTree() : root;
+        }
+
+    private:
+        const uint8* pos;
+        const uint8* const end;
+        Array<Identifier> identifiers;
+        bool failed = false;
+
+        size_t remaining() const noexcept { return static_cast<size_t> (end - pos); }
+
+        uint8 readByte() noexcept
+        {
+            if (pos >= end)
+            {
+                failed = true;
+                return 0;
+            }
+
+            return *pos++;
+        }
+
+        uint64 readVarint() noexcept
+        {
+            uint64 result = 0;
+
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                const auto byte = readByte();
+                result |= static_cast<uint64> (byte & 0x7f) << shift;
+
+                if ((byte & 0x80) == 0)
+                    return result;
+            }
+
+            failed = true;
+            return 0;
+        }
+
+        String readString()
+        {
+            const auto numBytes = readVarint();
+
+            if (failed || numBytes > remaining())
+            {
+                failed = true;
+                return {};
+            }
+
+            const auto s = String::fromUTF8 (reinterpret_cast<const char*> (pos), static_cast<int> (numBytes));
+            pos += numBytes;
+            return s;
+        }
+
+        Identifier readIdentifier()
+        {
+            const auto index = readVarint();
+
+            if (failed || index >= static_cast<uint64> (identifiers.size()))
+            {
+                failed = true;
+                return {};
+            }
+
+            return identifiers.getReference (static_cast<int> (index));
+        }
+
+        ValueTree readNode (int depth)
+        {
+            if (depth > maxSnapshotDepth)
+            {
+                failed = true;
+                return {};
+            }
+
+            const auto type = readIdentifier();
+            if (failed)
+                return {};
+
+            ValueTree tree (type);
+
+            const auto numProperties = readVarint();
+
+            for (uint64 i = 0; i < numProperties && ! failed; ++i)
+            {
+                const auto name = readIdentifier();
+                auto value = readValue (depth);
+
+                if (! failed)
+                    tree.setProperty (name, std::move (value), nullptr);
+            }
+
+            const auto numChildren = failed ? 0 : readVarint();
+
+            for (uint64 i = 0; i < numChildren && ! failed; ++i)
+            {
+                auto child = readNode (depth + 1);
+
+                if (! failed)
+                    tree.appendChild (child, nullptr);
+            }
+
+            return tree;
+        }
+
+        var readValue (int depth)
+        {
+            switch (static_cast<SnapshotTag> (readByte()))
+            {
+                case SnapshotTag::voidValue:    return {};
+                case SnapshotTag::falseValue:   return false;
+                case SnapshotTag::trueValue:    return true;
+                case SnapshotTag::intValue:     return static_cast<int> (fromZigzag (readVarint()));
+                case SnapshotTag::int64Value:   return fromZigzag (readVarint());
+                case SnapshotTag::stringValue:  return readString();
+
+                case SnapshotTag::doubleValue:
+                {
+                    if (remaining() < sizeof (uint64))
+                        break;
+
+                    const auto bits = ByteOrder::littleEndianInt64 (pos);
+                    pos += sizeof (uint64);
+
+                    double d;
+                    std::memcpy (&d, &bits, sizeof (d));
+                    return d;
+                }
+
+                case SnapshotTag::arrayValue:
+                {
+                    const auto numElements = readVarint();
+                    if (failed || depth > maxSnapshotDepth || numElements > remaining())
+                        break;
+
+                    Array<var> array;
+                    array.ensureStorageAllocated (static_cast<int> (numElements));
+
+                    for (uint64 i = 0; i < numElements && ! failed; ++i)
+                        array.add (readValue (depth + 1));
+
+                    return array;
+                }
+
+                case SnapshotTag::binaryValue:
+                {
+                    const auto numBytes = readVarint();
+                    if (failed || numBytes > remaining())
+                        break;
+
+                    MemoryBlock block (pos, static_cast<size_t> (numBytes));
+                    pos += numBytes;
+                    return block;
+                }
+
+                default:
+                    break;
+            }
+
+            failed = true;
+            return {};
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (SnapshotReader)
+    };
+}
+
+//==============================================================================
+void BinarySnapshot::write (const ValueTree& tree, OutputStream& output)
+{
+    jassert (tree.isValid());
+
+    SnapshotWriter (output).write (tree);
+}
+
+Result BinarySnapshot::save (const ValueTree& tree, const File& destination)
+{
+    TemporaryFile temp (destination);
+
+    {
+        FileOutputStream output (temp.getFile());
+
+        if (! output.openedOk())
+            return Result::fail (TRANS ("Failed to save!"));
+
+        write (tree, output);
+        output.flush();
+
+        if (output.getStatus().failed())
+            return output.getStatus();
+    }
+
+    if (temp.overwriteTargetFileWithTemporary())
+        return Result::ok();
+
+    return Result::fail (TRANS ("Failed to save!"));
+}
+
+ValueTree BinarySnapshot::read (const void* data, size_t numBytes)
+{
+    if (data == nullptr)
+        return {};
+
+    return SnapshotReader (data, numBytes).read();
+}
+
+ValueTree BinarySnapshot::load (const File& source)
+{
+    const MemoryMappedFile mappedFile (source, MemoryMappedFile::readOnly);
+
+    return read (mappedFile.getData(), mappedFile.getSize());
+}
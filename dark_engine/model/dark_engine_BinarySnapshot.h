@@ -0,0 +1,48 @@
+//==============================================================================
+/** A compact, versioned binary format for saving and loading engine state.
+
+    Unlike the XML and JSON paths, identifiers are written once into a table
+    and then referred to by index, integers (which covers enums and the
+    geometry packed by PropertyConverter) are written as variable-length
+    integers, and snapshots are read straight out of a memory-mapped file
+    instead of being loaded into a String and parsed.
+
+    The layout is as follows, where every count, index and integer
+    is an unsigned LEB128 varint, and signed integers are zigzag encoded:
+    @code
+        "DkSn"          4 byte magic
+        version         uint16, little-endian
+        identifiers     a count, then each identifier as its UTF-8 length and bytes
+        root node       a type index,
+                        a property count, then each property as a name index, a tag byte and a payload,
+                        a child count, then each child node
+    @endcode
+
+    @see EngineObject::saveBinary, EngineObject::loadBinary
+*/
+class BinarySnapshot final
+{
+public:
+    /** The version written by this build, and the newest one it can read. */
+    static constexpr int currentVersion = 1;
+
+    //==============================================================================
+    /** Writes a snapshot of the tree to the stream. */
+    static void write (const ValueTree& tree, OutputStream& output);
+
+    /** Writes a snapshot of the tree to a temporary file that then replaces the destination. */
+    [[nodiscard]] static Result save (const ValueTree& tree, const File& destination);
+
+    //==============================================================================
+    /** @returns the tree held by the snapshot, or an invalid tree if the data isn't a valid snapshot. */
+    [[nodiscard]] static ValueTree read (const void* data, size_t numBytes);
+
+    /** @returns the tree held by the snapshot file, which is memory-mapped rather than loaded,
+        or an invalid tree if the file couldn't be read or isn't a valid snapshot.
+    */
+    [[nodiscard]] static ValueTree load (const File& source);
+
+private:
+    //==============================================================================
+    BinarySnapshot() = delete;
+};
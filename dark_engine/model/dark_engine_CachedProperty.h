@@ -0,0 +1,347 @@
+//==============================================================================
+/** The type-erased part of a CachedProperty, as seen by its PropertyDispatcher.
+
+    @see CachedProperty, PropertyDispatcher
+*/
+class CachedPropertyBase
+{
+public:
+    /** */
+    CachedPropertyBase() = default;
+    /** */
+    virtual ~CachedPropertyBase() = default;
+
+    //==============================================================================
+    /** @returns the property this is caching. */
+    [[nodiscard]] const Identifier& getPropertyID() const noexcept  { return property; }
+
+    /** @returns true if neither the tree nor its fallback have the property, meaning the default value is being used. */
+    [[nodiscard]] bool isUsingDefault() const                       { return ! tree.hasProperty (property) && ! fallback.hasProperty (property); }
+
+protected:
+    //==============================================================================
+    ValueTree tree, fallback;
+    Identifier property;
+
+    /** Re-reads the value from the tree. */
+    virtual void refresh() = 0;
+
+private:
+    //==============================================================================
+    friend class PropertyDispatcher;
+
+    JUCE_DECLARE_NON_COPYABLE (CachedPropertyBase)
+};
+
+//==============================================================================
+class PropertyDispatcher;
+
+/** The single listener on a tree that many PropertyDispatchers fall back to,
+    like the definition of a prototype that every enemy of its kind is made from.
+
+    Without one, each dispatcher would add itself as a listener to the shared tree,
+    making every object that's wrapped and let go pay to search its listener list.
+    Dispatchers are added to and removed from this one in constant time instead.
+
+    @see PropertyDispatcher::setFallback, DefinitionIndex
+*/
+class SharedFallback final : public ReferenceCountedObject,
+                             private ValueTree::Listener
+{
+public:
+    /** */
+    using Ptr = ReferenceCountedObjectPtr<SharedFallback>;
+
+    /** */
+    explicit SharedFallback (const ValueTree& treeToListenTo) :
+        tree (treeToListenTo)
+    {
+        tree.addListener (this);
+    }
+
+    /** */
+    ~SharedFallback() override
+    {
+        // The dispatchers hold on to this, so it can't go while any are using it!
+        jassert (dispatchers.isEmpty());
+        tree.removeListener (this);
+    }
+
+    //==============================================================================
+    /** @returns the tree that's being listened to. */
+    [[nodiscard]] const ValueTree& getTree() const noexcept { return tree; }
+
+    /** @returns the number of dispatchers falling back to the tree. */
+    [[nodiscard]] int getNumDispatchers() const noexcept    { return dispatchers.size(); }
+
+private:
+    //==============================================================================
+    friend class PropertyDispatcher;
+
+    ValueTree tree;
+    Array<PropertyDispatcher*> dispatchers;
+
+    void add (PropertyDispatcher&);
+    void remove (PropertyDispatcher&);
+
+    void valueTreePropertyChanged (ValueTree&, const Identifier&) override;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SharedFallback)
+};
+
+//==============================================================================
+/** A cached copy of a ValueTree property, much like a juce::CachedValue.
+
+    Unlike a CachedValue, this doesn't listen to the tree itself:
+    the PropertyDispatcher it's bound to is the only listener,
+    and it only refreshes the caches of the property that changed.
+
+    @see PropertyDispatcher, EngineObject
+*/
+template<typename Type>
+class CachedProperty final : public CachedPropertyBase
+{
+public:
+    /** */
+    CachedProperty() = default;
+
+    //==============================================================================
+    /** @returns the cached value. */
+    [[nodiscard]] const Type& get() const noexcept      { return cachedValue; }
+    /** @returns the cached value. */
+    operator const Type&() const noexcept               { return cachedValue; }
+    /** @returns the value used when the tree doesn't have the property. */
+    [[nodiscard]] const Type& getDefault() const noexcept { return defaultValue; }
+
+    /** Sets the property on the tree, which will update the cache through the dispatcher. */
+    void setValue (const Type& newValue, UndoManager* undoManager)
+    {
+        jassert (tree.isValid());
+        tree.setProperty (property, PropertyConverter<Type>::toVar (newValue), undoManager);
+    }
+
+private:
+    //==============================================================================
+    friend class PropertyDispatcher;
+
+    Type defaultValue {}, cachedValue {};
+
+    void refresh() override
+    {
+        if (const auto* v = tree.getPropertyPointer (property))
+            cachedValue = PropertyConverter<Type>::fromVar (*v);
+        else if (const auto* inherited = fallback.getPropertyPointer (property))
+            cachedValue = PropertyConverter<Type>::fromVar (*inherited);
+        else
+            cachedValue = defaultValue;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (CachedProperty)
+};
+
+//==============================================================================
+/** The single ValueTree listener for all of an object's CachedProperty members.
+
+    Property changes are looked up by identifier in a sorted table of slots,
+    so only the caches of the property that changed get refreshed,
+    instead of every cache comparing identifiers for every change.
+
+    The caches can also fall back to a second tree, like an object's prototype,
+    for the properties that the main tree doesn't have. A change to the fallback
+    shows up straight away, through the SharedFallback listening to it.
+
+    @see CachedProperty, EngineObject
+*/
+class PropertyDispatcher final : private ValueTree::Listener
+{
+public:
+    /** */
+    PropertyDispatcher() = default;
+
+    /** */
+    ~PropertyDispatcher() override
+    {
+        tree.removeListener (this);
+        releaseFallback();
+    }
+
+    //==============================================================================
+    /** Binds the cache to the tree's property, switching the tree of every other bound cache if it differs. */
+    template<typename Type>
+    void bind (CachedProperty<Type>& cache, const ValueTree& treeToUse,
+               const Identifier& property, const Type& defaultValue)
+    {
+        setTree (treeToUse);
+
+        unbind (cache);
+
+        cache.tree = tree;
+        cache.fallback = fallback;
+        cache.property = property;
+        cache.defaultValue = defaultValue;
+        cache.refresh();
+
+        const auto key = toKey (property);
+        int index = findFirstSlot (key);
+
+        while (index < slots.size() && slots.getReference (index).key == key)
+            ++index;
+
+        slots.insert (index, { key, &cache });
+    }
+
+    /** Switches every bound cache over to a different tree, refreshing them all. */
+    void setTree (const ValueTree& newTree)
+    {
+        if (newTree == tree)
+            return;
+
+        tree.removeListener (this);
+        tree = newTree;
+        tree.addListener (this);
+
+        for (auto& slot : slots)
+        {
+            slot.cache->tree = tree;
+            slot.cache->refresh();
+        }
+    }
+
+    /** Switches every bound cache over to a different tree to fall back to, refreshing them all.
+
+        If the shared listener is for the same tree, like the one that a DefinitionIndex keeps
+        for each definition, it's used to hear about the fallback's changes. Otherwise,
+        this makes its own, which is fine for a fallback that few objects share.
+    */
+    void setFallback (const ValueTree& newFallback, SharedFallback::Ptr sharedListener = nullptr)
+    {
+        if (newFallback == fallback)
+            return;
+
+        releaseFallback();
+        fallback = newFallback;
+
+        if (fallback.isValid())
+        {
+            if (sharedListener == nullptr || sharedListener->getTree() != fallback)
+                sharedListener = new SharedFallback (fallback);
+
+            fallbackListener = std::move (sharedListener);
+            fallbackListener->add (*this);
+        }
+
+        for (auto& slot : slots)
+        {
+            slot.cache->fallback = fallback;
+            slot.cache->refresh();
+        }
+    }
+
+    /** @returns the number of bound caches. */
+    [[nodiscard]] int getNumBoundProperties() const noexcept { return slots.size(); }
+
+private:
+    //==============================================================================
+    struct Slot final
+    {
+        pointer_sized_uint key = 0;
+        CachedPropertyBase* cache = nullptr;
+    };
+
+    ValueTree tree, fallback;
+    SharedFallback::Ptr fallbackListener;
+    int fallbackListenerIndex = -1; // Where this is in the listener's dispatchers.
+    Array<Slot> slots; // Sorted by key.
+
+    //==============================================================================
+    /** Identifiers are pooled, so their text's address is a unique and stable key. */
+    [[nodiscard]] static pointer_sized_uint toKey (const Identifier& id) noexcept
+    {
+        return reinterpret_cast<pointer_sized_uint> (id.getCharPointer().getAddress());
+    }
+
+    void unbind (CachedPropertyBase& cache)
+    {
+        for (int i = slots.size(); --i >= 0;)
+            if (slots.getReference (i).cache == &cache)
+                slots.remove (i);
+    }
+
+    [[nodiscard]] int findFirstSlot (pointer_sized_uint key) const noexcept
+    {
+        int start = 0, end = slots.size();
+
+        while (start < end)
+        {
+            const auto mid = start + (end - start) / 2;
+
+            if (slots.getReference (mid).key < key)
+                start = mid + 1;
+            else
+                end = mid;
+        }
+
+        return start;
+    }
+
+    void releaseFallback()
+    {
+        if (fallbackListener != nullptr)
+        {
+            fallbackListener->remove (*this);
+            fallbackListener = nullptr;
+        }
+
+        fallback = {};
+    }
+
+    void refresh (const Identifier& property)
+    {
+        const auto key = toKey (property);
+
+        for (int i = findFirstSlot (key); i < slots.size() && slots.getReference (i).key == key; ++i)
+            slots.getReference (i).cache->refresh();
+    }
+
+    void valueTreePropertyChanged (ValueTree& changedTree, const Identifier& property) override
+    {
+        if (changedTree == tree)
+            refresh (property);
+    }
+
+    //==============================================================================
+    friend class SharedFallback;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PropertyDispatcher)
+};
+
+//==============================================================================
+inline void SharedFallback::add (PropertyDispatcher& dispatcher)
+{
+    dispatcher.fallbackListenerIndex = dispatchers.size();
+    dispatchers.add (&dispatcher);
+}
+
+inline void SharedFallback::remove (PropertyDispatcher& dispatcher)
+{
+    const auto index = dispatcher.fallbackListenerIndex;
+    jassert (dispatchers[index] == &dispatcher);
+
+    // Moves the last dispatcher into the gap, instead of shuffling every one after it down.
+    auto* last = dispatchers.getLast();
+    dispatchers.set (index, last);
+    last->fallbackListenerIndex = index;
+    dispatchers.removeLast();
+
+    dispatcher.fallbackListenerIndex = -1;
+}
+
+inline void SharedFallback::valueTreePropertyChanged (ValueTree& changedTree, const Identifier& property)
+{
+    if (changedTree != tree)
+        return; // A change to one of its children, like a definition's fighting moves.
+
+    for (auto* dispatcher : dispatchers)
+        dispatcher->refresh (property);
+}
@@ -0,0 +1,133 @@
+//==============================================================================
+/** The stats of a FightableEntity that a Nature can raise or lower. */
+enum class Stat
+{
+    attack,
+    defense,
+    specialAttack,
+    specialDefense,
+    speed,
+
+    numStats = speed + 1
+};
+
+//==============================================================================
+/** The compile-time tables that fights are worked out with.
+
+    @see DamageBatch, MoveType, Nature
+*/
+struct CombatTables final
+{
+    //==============================================================================
+    /** Type effectiveness is in quarters, so that it stays an integer. */
+    static constexpr int neutral = 4;
+
+    /** How effective a move of a type (the row) is against an entity that's weak
+        against a type (the column), in quarters: 0 is no effect, 2 is half, 4 is
+        neutral and 8 is double.
+
+        An entity is always hit for double by the type it's weak against,
+        and that weakness also tells what it resists. For example, something
+        weak against water is fiery, so it shrugs off fire and ice.
+    */
+    static constexpr uint8 effectiveness[(int) MoveType::numMoveTypes][(int) MoveType::numMoveTypes] =
+    {
+        //   Weak against:
+        //   nrm  ear  wnd  wat  ice  fir  ele  pla  poi
+        {    8,   4,   4,   4,   4,   4,   4,   2,   4 },  // normal
+        {    4,   8,   4,   4,   4,   4,   4,   4,   2 },  // earth
+        {    4,   4,   8,   4,   2,   4,   4,   4,   4 },  // wind
+        {    4,   4,   4,   8,   4,   4,   2,   4,   2 },  // water
+        {    4,   4,   4,   2,   8,   2,   4,   4,   4 },  // ice
+        {    4,   4,   4,   2,   4,   8,   2,   4,   4 },  // fire
+        {    4,   2,   0,   4,   4,   4,   8,   4,   4 },  // electric
+        {    4,   4,   4,   4,   4,   4,   4,   8,   4 },  // plasma
+        {    4,   4,   2,   4,   4,   4,   4,   0,   8 }   // poison
+    };
+
+    /** @returns how effective a move of the type is against an entity that's weak against the other, in quarters. */
+    [[nodiscard]] static constexpr int getEffectiveness (MoveType moveType, MoveType weakAgainstType) noexcept
+    {
+        const auto m = static_cast<int> (moveType), w = static_cast<int> (weakAgainstType);
+
+        if (! isPositiveAndBelow (m, (int) MoveType::numMoveTypes)
+            || ! isPositiveAndBelow (w, (int) MoveType::numMoveTypes))
+            return neutral;
+
+        return effectiveness[m][w];
+    }
+
+    //==============================================================================
+    /** Nature modifiers are in tenths, so that they stay integers. */
+    static constexpr int unmodified = 10;
+
+    /** How each Nature scales each Stat, in tenths: every nature raises one stat by 10%
+        and lowers another by 10%, except the neutral ones, whose changes cancel out.
+    */
+    static constexpr uint8 natureModifiers[(int) Nature::numNatures][(int) Stat::numStats] =
+    {
+        //   atk  def  spa  spd  spe
+        {    11,  10,  9,   10,  10 },  // adamant
+        {    10,  10,  10,  10,  10 },  // bashful
+        {    9,   11,  10,  10,  10 },  // bold
+        {    11,  10,  10,  10,  9  },  // brave
+        {    9,   10,  10,  11,  10 },  // calm
+        {    10,  10,  9,   11,  10 },  // careful
+        {    10,  10,  10,  10,  10 },  // docile
+        {    10,  9,   10,  11,  10 },  // gentle
+        {    10,  10,  10,  10,  10 },  // hardy
+        {    10,  9,   10,  10,  11 },  // hasty
+        {    10,  11,  9,   10,  10 },  // impish
+        {    10,  10,  9,   10,  11 },  // jolly
+        {    10,  11,  10,  9,   10 },  // lax
+        {    11,  9,   10,  10,  10 },  // lonely
+        {    10,  9,   11,  10,  10 },  // mild
+        {    9,   10,  11,  10,  10 },  // modest
+        {    10,  10,  10,  9,   11 },  // naive
+        {    11,  10,  10,  9,   10 },  // naughty
+        {    10,  10,  11,  10,  9  },  // quiet
+        {    10,  10,  10,  10,  10 },  // quirky
+        {    10,  10,  11,  9,   10 },  // rash
+        {    10,  11,  10,  10,  9  },  // relaxed
+        {    10,  10,  10,  11,  9  },  // sassy
+        {    10,  10,  10,  10,  10 },  // serious
+        {    9,   10,  10,  10,  11 }   // timid
+    };
+
+    /** @returns how the nature scales the stat, in tenths. */
+    [[nodiscard]] static constexpr int getNatureModifier (Nature nature, Stat stat) noexcept
+    {
+        const auto n = static_cast<int> (nature), s = static_cast<int> (stat);
+
+        if (! isPositiveAndBelow (n, (int) Nature::numNatures)
+            || ! isPositiveAndBelow (s, (int) Stat::numStats))
+            return unmodified;
+
+        return natureModifiers[n][s];
+    }
+
+    /** @returns the stat's value as scaled by the nature, rounded down. */
+    [[nodiscard]] static constexpr int applyNature (int value, Nature nature, Stat stat) noexcept
+    {
+        return value * getNatureModifier (nature, stat) / unmodified;
+    }
+
+    /** @returns true if every nature raises a stat by as much as it lowers another. */
+    [[nodiscard]] static constexpr bool isBalanced() noexcept
+    {
+        for (const auto& row : natureModifiers)
+        {
+            int total = 0;
+
+            for (const auto m : row)
+                total += m - unmodified;
+
+            if (total != 0)
+                return false;
+        }
+
+        return true;
+    }
+};
+
+static_assert (CombatTables::isBalanced(), "Every nature should raise a stat by as much as it lowers another!");
@@ -1,3 +1,50 @@
+//==============================================================================
+/** Refers to a shared definition, like an entry of GameMap::getEnemiesState(),
+    that an EngineObject created from it falls back to for any property it
+    doesn't override.
+
+    @see EngineObject, GameMap::findDefinition
+*/
+struct Prototype final
+{
+    /** */
+    ValueTree definition;
+
+    /** The listener on the definition that every object made from it shares.
+        If this is null, each object listens to the definition on its own.
+        @see DefinitionIndex::findPrototype
+    */
+    SharedFallback::Ptr listener;
+
+    /** Finds a definition by its key.
+        @see GameMap::findDefinition, getKey
+    */
+    using DefinitionFinder = std::function<ValueTree (const String& definitionKey)>;
+
+    /** @returns the key that the objects made from the definition refer to it by:
+        its definitionKey, which stays the same whatever language the content was loaded in,
+        or its name if it doesn't have one (eg: a definition made in code).
+    */
+    [[nodiscard]] static String getKey (const ValueTree& definition)
+    {
+        if (const auto* key = definition.getPropertyPointer (definitionKeyId))
+            return key->toString();
+
+        return definition[nameId].toString();
+    }
+
+    /** @returns the prototype that an existing state was made from, going by its prototypeId,
+        which will have an invalid definition if it wasn't made from one or it can't be found.
+    */
+    [[nodiscard]] static Prototype of (const ValueTree& state, const DefinitionFinder& findDefinition)
+    {
+        if (const auto* key = state.getPropertyPointer (prototypeId); key != nullptr && findDefinition != nullptr)
+            return { findDefinition (key->toString()) };
+
+        return {};
+    }
+};
+
 //==============================================================================
 /** A generic, low-level object that can exist within a GameMap.
 
@@ -15,14 +62,59 @@ public:
         setupPropAndCache (undoManager);
     }
 
-    /** */
+    /** Wraps an existing state, writing the default of any property it's missing,
+        unless it was made from a prototype: see the other constructor for those.
+    */
     EngineObject (const ValueTree& existingState, UndoManager* undoManager = nullptr) :
-        EngineObject (existingState.getType(), undoManager)
+        EngineObject (existingState, Prototype(), undoManager)
+    {
+    }
+
+    /** Wraps an existing state that was made from a prototype, such as one that was saved and loaded,
+        falling back to the prototype for any property it doesn't override.
+
+        Nothing is written to a state that refers to a prototype, even if the prototype
+        can't be found, in which case the defaults are used until it's wrapped again.
+
+        @see Prototype::of
+    */
+    EngineObject (const ValueTree& existingState, const Prototype& prototypeToUse, UndoManager* undoManager = nullptr) :
+        Identifiable (existingState.getType()),
+        state (existingState),
+        prototype (prototypeToUse.definition)
+    {
+        // The state refers to a different definition than the one provided!
+        jassert (! prototype.isValid() || ! state.hasProperty (prototypeId)
+                 || state[prototypeId].toString() == Prototype::getKey (prototype));
+
+        dispatcher.setFallback (prototype, prototypeToUse.listener);
+        setupPropAndCache (undoManager);
+    }
+
+    /** Creates an object that only stores the properties that differ from its prototype.
+
+        The object's state will have the same type as the prototype's definition,
+        and will refer to the definition by its key.
+
+        @see Prototype::getKey
+    */
+    EngineObject (const Prototype& prototypeToUse, UndoManager* undoManager = nullptr) :
+        Identifiable (prototypeToUse.definition.getType()),
+        state (prototypeToUse.definition.getType()),
+        prototype (prototypeToUse.definition)
     {
-        state = existingState;
+        jassert (prototype.isValid());
+
+        if (const auto key = Prototype::getKey (prototype); key.isNotEmpty())
+            state.setProperty (prototypeId, key, undoManager);
+
+        dispatcher.setFallback (prototype, prototypeToUse.listener);
         setupPropAndCache (undoManager);
     }
 
+    /** */
+    virtual ~EngineObject() = default;
+
     //==============================================================================
     /** Untranslated. */
     EngineObject& setName (const String& newName, UndoManager* undoManager = nullptr)
@@ -48,6 +140,21 @@ public:
     /** @returns the state of this EngineObject. */
     [[nodiscard]] ValueTree getState() const noexcept { return state; }
 
+    /** @returns the definition this object falls back to, which will be invalid if it has no prototype. */
+    [[nodiscard]] ValueTree getPrototype() const noexcept { return prototype; }
+
+    /** @returns true if the property is set on this object itself
+        rather than being inherited from its prototype.
+    */
+    [[nodiscard]] bool overridesProperty (const Identifier& id) const noexcept { return state.hasProperty (id); }
+
+    /** Removes this object's own value for the property so that it falls back to its prototype's. */
+    void resetToPrototype (const Identifier& id, UndoManager* undoManager = nullptr)
+    {
+        jassert (prototype.isValid());
+        state.removeProperty (id, undoManager);
+    }
+
     /** @returns true if the EngineObject has the same type and state as this one.
         @see getType
     */
@@ -59,32 +166,50 @@ public:
     bool operator!= (const EngineObject& other) const noexcept { return ! operator== (other); }
 
     //==============================================================================
-    /** @returns the value of a named property.
+    /** @returns the value of a named property, falling back to the prototype's.
         If no such property has been set, this will return a void variant.
         You can also use operator[] to get a property.
         @see var, setProperty, getPropertyPointer, hasProperty
     */
-    const var& getProperty (const Identifier& id) const noexcept { return state.getProperty (id); }
+    const var& getProperty (const Identifier& id) const noexcept
+    {
+        if (const auto* v = state.getPropertyPointer (id))
+            return *v;
+
+        return prototype.getProperty (id);
+    }
 
-    /** @returns the value of a named property, or the value of defaultReturnValue
-        if the property doesn't exist.
+    /** @returns the value of a named property, falling back to the prototype's,
+        or the value of defaultReturnValue if the property doesn't exist.
         You can also use operator[] and getProperty to get a property.
         @see var, getProperty, getPropertyPointer, setProperty, hasProperty
     */
-    var getProperty (const Identifier& id, const var& defaultReturnValue) const { return state.getProperty (id, defaultReturnValue); }
+    var getProperty (const Identifier& id, const var& defaultReturnValue) const
+    {
+        if (const auto* v = getPropertyPointer (id))
+            return *v;
+
+        return defaultReturnValue;
+    }
 
-    /** @returns a pointer to the value of a named property, or nullptr if the property
-        doesn't exist.
+    /** @returns a pointer to the value of a named property, falling back to the prototype's,
+        or nullptr if the property doesn't exist.
         @see var, getProperty, setProperty, hasProperty
     */
-    const var* getPropertyPointer (const Identifier& id) const noexcept { return state.getPropertyPointer (id); }
+    const var* getPropertyPointer (const Identifier& id) const noexcept
+    {
+        if (const auto* v = state.getPropertyPointer (id))
+            return v;
+
+        return prototype.getPropertyPointer (id);
+    }
 
     /** @returns the value of a named property.
         If no such property has been set, this will return a void variant. This is the same as
         calling getProperty().
         @see getProperty
     */
-    const var& operator[] (const Identifier& id) const noexcept { return state[id]; }
+    const var& operator[] (const Identifier& id) const noexcept { return getProperty (id); }
 
     /** Changes a named property of the tree.
         The name identifier must not be an empty string.
@@ -95,7 +220,9 @@ public:
     */
     ValueTree& setProperty (const Identifier& id, const var& newValue, UndoManager* undoManager) { return state.setProperty (id, newValue, undoManager); }
 
-    /** @returns true if the tree contains a named property. */
+    /** @returns true if the tree contains a named property, ignoring the prototype.
+        @see overridesProperty
+    */
     bool hasProperty (const Identifier& id) const noexcept { return state.hasProperty (id); }
 
     /** Removes a property from the tree.
@@ -183,6 +310,7 @@ public:
         if (vt.hasType (getIdentifier()))
         {
             state = vt;
+            dispatcher.setTree (state);
             return Result::ok();
         }
 
@@ -208,6 +336,35 @@ public:
         if (vt.hasType (getIdentifier()))
         {
             state = vt;
+            dispatcher.setTree (state);
+            return Result::ok();
+        }
+
+        jassertfalse;
+        return Result::fail (TRANS ("Failed to load!"));
+    }
+
+    /** Saves the state as a compact binary snapshot.
+        @see BinarySnapshot
+    */
+    [[nodiscard]] Result saveBinary (const File& dest) const
+    {
+        const auto result = BinarySnapshot::save (state, dest);
+        jassert (result.wasOk());
+        return result;
+    }
+
+    /** Loads the state from a binary snapshot, reading it straight from a memory-mapped file.
+        @see BinarySnapshot
+    */
+    [[nodiscard]] Result loadBinary (const File& source)
+    {
+        const auto vt = BinarySnapshot::load (source);
+
+        if (vt.hasType (getIdentifier()))
+        {
+            state = vt;
+            dispatcher.setTree (state);
             return Result::ok();
         }
 
@@ -217,21 +374,54 @@ public:
 
 protected:
     //==============================================================================
-    ValueTree state;
+    ValueTree state, prototype;
 
-    /** @returns */
+    /** Binds the cached value to the property.
+
+        If this object was made from a prototype, the property isn't written
+        and the cache falls back to the prototype's current value,
+        or to the provided value if the prototype doesn't have the property either.
+
+        Otherwise the provided value is written if the state doesn't already have one.
+
+        @returns
+    */
     template<typename Type>
-    ValueTree& setupPropAndCache (CachedValue<Type>& cv, const Identifier& id,
+    ValueTree& setupPropAndCache (CachedProperty<Type>& cv, const Identifier& id,
                                   const Type& value, UndoManager* undoManager)
     {
-        setProperty (id, juce::VariantConverter<Type>::toVar (value), undoManager);
-        cv.referTo (state, id, undoManager);
+        if (! prototype.isValid() && ! state.hasProperty (prototypeId) && ! state.hasProperty (id))
+            setProperty (id, PropertyConverter<Type>::toVar (value), undoManager);
+
+        dispatcher.bind (cv, state, id, value);
         return state;
     }
 
+    /** Makes the child refer to the state's existing child of the same type, like when wrapping
+        a saved state. If there isn't one, the child is left out of the state until attachChild()
+        is called, once there's something to put in it, so that objects don't carry empty children.
+    */
+    void adoptChild (ValueTree& child) const
+    {
+        if (auto existing = state.getChildWithName (child.getType()); existing.isValid())
+            child = existing;
+    }
+
+    /** Adds a child set up by adoptChild() to the state, unless it's already there.
+        @returns the child.
+    */
+    ValueTree& attachChild (ValueTree& child, UndoManager* undoManager)
+    {
+        if (child.getParent() != state)
+            state.appendChild (child, undoManager);
+
+        return child;
+    }
+
 private:
     //==============================================================================
-    CachedValue<String> name, description;
+    PropertyDispatcher dispatcher;
+    CachedProperty<String> name, description;
 
     //==============================================================================
     void setupPropAndCache (UndoManager* undoManager)
@@ -245,6 +435,8 @@ private:
 };
 
 //==============================================================================
+class WorldTicker;
+
 /** */
 class WorldObject : public EngineObject
 {
@@ -266,6 +458,22 @@ public:
         setupPropAndCache (undoManager);
     }
 
+    /** Wraps an existing state that was made from a prototype.
+        @see EngineObject
+    */
+    WorldObject (const ValueTree& existingState, const Prototype& prototypeToUse, UndoManager* undoManager = nullptr) :
+        EngineObject (existingState, prototypeToUse, undoManager)
+    {
+        setupPropAndCache (undoManager);
+    }
+
+    /** */
+    WorldObject (const Prototype& prototypeToUse, UndoManager* undoManager = nullptr) :
+        EngineObject (prototypeToUse, undoManager)
+    {
+        setupPropAndCache (undoManager);
+    }
+
     //==============================================================================
     /** */
     WorldObject& setDimensions (Rectangle<int> newDimensions, UndoManager* undoManager = nullptr)
@@ -338,10 +546,16 @@ public:
         selectively enabled and disabled here, and any other state might want
         to be considered or changed.
 
-        This will be called prior to recreating icons.
+        This will be called prior to recreating icons, and by a WorldTicker
+        whenever this object's state changes or a timer it scheduled is due.
+
+        @see WorldTicker
     */
     virtual void update() { }
 
+    /** @returns the WorldTicker this object is registered with, if any. */
+    [[nodiscard]] WorldTicker* getTicker() const noexcept { return ticker; }
+
     /** */
     String getMapIcon() const       { return mapIcon.get(); }
     /** */
@@ -372,23 +586,24 @@ public:
 
 private:
     //==============================================================================
-    CachedValue<Rectangle<int>> dimensions;
-    CachedValue<String> interactionId, mapIcon, screenIcon, inventoryIcon;
-    CachedValue<Colour> lightColour;
-    CachedValue<int> lightRadius;
+    CachedProperty<Rectangle<int>> dimensions;
+    CachedProperty<String> interactionId, mapIcon, screenIcon, inventoryIcon;
+    CachedProperty<Colour> lightColour;
+    CachedProperty<int> lightRadius;
+
+    friend class WorldTicker;
+    WorldTicker* ticker = nullptr;
 
     //==============================================================================
     void setupPropAndCache (UndoManager* undoManager)
     {
-        EngineObject::setupPropAndCache (dimensions, dimensionsId, {}, undoManager);
+        EngineObject::setupPropAndCache (dimensions, dimensionsId, { 0, 0, 1, 1 }, undoManager);
         EngineObject::setupPropAndCache (interactionId, interactionIdId, {}, undoManager);
         EngineObject::setupPropAndCache (mapIcon, mapIconId, {}, undoManager);
         EngineObject::setupPropAndCache (screenIcon, screenIconId, {}, undoManager);
         EngineObject::setupPropAndCache (inventoryIcon, inventoryIconId, {}, undoManager);
         EngineObject::setupPropAndCache (lightColour, lightColourId, {}, undoManager);
         EngineObject::setupPropAndCache (lightRadius, lightRadiusId, {}, undoManager);
-
-        setSize (1, 1, undoManager);
     }
 
     //==============================================================================
@@ -504,28 +719,44 @@ private:
 };
 
 /** @returns */
-inline String toString (StatusCondition statusCondition, bool asArray = false)
+inline const String& toString (StatusCondition statusCondition, bool asArray = false)
 {
-    if (statusCondition.isNormal())
-        return TRANS ("Normal");
-
-    StringArray s;
-    s.ensureStorageAllocated (statusCondition.getNumConditions());
-
-    if (statusCondition.isBurned())         s.add (TRANS ("Burned"));
-    if (statusCondition.isFrozen())         s.add (TRANS ("Frozen"));
-    if (statusCondition.isParalysed())      s.add (TRANS ("Paralysed"));
-    if (statusCondition.isPoisoned())       s.add (TRANS ("Poisoned"));
-    if (statusCondition.isAsleep())         s.add (TRANS ("Asleep"));
-    if (statusCondition.isDrowsy())         s.add (TRANS ("Drowsy"));
-    if (statusCondition.isFrostbitten())    s.add (TRANS ("Frostbitten"));
-    if (statusCondition.isBound())          s.add (TRANS ("Bound"));
-    if (statusCondition.isCursed())         s.add (TRANS ("Cursed"));
-
-    if (asArray)
-        return s.strings.getFirst();
-
-    return s.joinIntoString (", ");
+    // Every combination of flags, indexed by the flags themselves:
+    static const LocalisedStringTable names (1 << StatusCondition::numFlags, [] (int flags)
+    {
+        static constexpr const char* flagNames[] =
+        {
+            NEEDS_TRANS ("Burned"),
+            NEEDS_TRANS ("Frozen"),
+            NEEDS_TRANS ("Paralysed"),
+            NEEDS_TRANS ("Poisoned"),
+            NEEDS_TRANS ("Asleep"),
+            NEEDS_TRANS ("Drowsy"),
+            NEEDS_TRANS ("Frostbitten"),
+            NEEDS_TRANS ("Bound"),
+            NEEDS_TRANS ("Cursed")
+        };
+
+        static_assert (std::size (flagNames) == StatusCondition::numFlags);
+
+        if (flags == 0)
+            return TRANS ("Normal");
+
+        StringArray s;
+
+        for (int i = 0; i < StatusCondition::numFlags; ++i)
+            if ((flags & (1 << i)) != 0)
+                s.add (TRANS (flagNames[i]));
+
+        return s.joinIntoString (", ");
+    });
+
+    auto flags = statusCondition.getFlags() & ((1 << StatusCondition::numFlags) - 1);
+
+    if (asArray && flags != 0)
+        flags &= -flags; // Only the first condition.
+
+    return names[flags];
 }
 
 //==============================================================================
@@ -537,7 +768,9 @@ enum class CardinalDirection
     north,
     east,
     south,
-    west
+    west,
+
+    numCardinalDirections = west + 1
 };
 
 /** */
@@ -561,21 +794,19 @@ inline double toDegrees (CardinalDirection cd) noexcept
 }
 
 /** @returns */
-inline String toString (CardinalDirection cd)
+inline const String& toString (CardinalDirection cd)
 {
-    switch (cd)
+    static const LocalisedStringTable names
     {
-        case CardinalDirection::notApplicable:      return TRANS ("(N/A)");
-        case CardinalDirection::omnidirectional:    return TRANS ("omni");
-        case CardinalDirection::north:              return TRANS ("north");
-        case CardinalDirection::east:               return TRANS ("east");
-        case CardinalDirection::south:              return TRANS ("south");
-        case CardinalDirection::west:               return TRANS ("west");
-        default: break;
+        NEEDS_TRANS ("(N/A)"),
+        NEEDS_TRANS ("omni"),
+        NEEDS_TRANS ("north"),
+        NEEDS_TRANS ("east"),
+        NEEDS_TRANS ("south"),
+        NEEDS_TRANS ("west")
     };
 
-    jassertfalse;
-    return {};
+    return names[static_cast<int> (cd)];
 }
 
 /** @returns */
@@ -610,31 +841,49 @@ enum class Material
 };
 
 /** @returns */
-inline String toString (Material materialType, bool asAdjective = false)
+inline const String& toString (Material materialType, bool asAdjective = false)
 {
-    switch (materialType)
-    {
-        case Material::tile:        { return asAdjective ? TRANS ("tiled")      : TRANS ("tile"); }
-        case Material::dirt:        { return asAdjective ? TRANS ("dirty")      : TRANS ("dirt"); }
-        case Material::grass:       { return asAdjective ? TRANS ("grassy")      : TRANS ("grass"); }
-        case Material::brick:       { return asAdjective ? TRANS ("brick")      : TRANS ("brick"); }
-        case Material::glass:       { return asAdjective ? TRANS ("glass")      : TRANS ("glass"); }
-        case Material::wood:        { return asAdjective ? TRANS ("wooden")     : TRANS ("wood"); }
-        case Material::metal:       { return asAdjective ? TRANS ("metallic")   : TRANS ("metal"); }
-        case Material::vinyl:       { return asAdjective ? TRANS ("vinyl")      : TRANS ("vinyl"); }
-        case Material::stone:       { return asAdjective ? TRANS ("stone")      : TRANS ("stone"); }
-        case Material::marble:      { return asAdjective ? TRANS ("marbled")    : TRANS ("marble"); }
-        case Material::concrete:    { return asAdjective ? TRANS ("concrete")   : TRANS ("concrete"); }
-        case Material::cement:      { return asAdjective ? TRANS ("cemented")   : TRANS ("cement"); }
-        case Material::plastic:     { return asAdjective ? TRANS ("plastic")    : TRANS ("plastic"); }
-        case Material::ice:         { return asAdjective ? TRANS ("iced")       : TRANS ("ice"); }
-        case Material::ooze:        { return asAdjective ? TRANS ("ooze")       : TRANS ("ooze"); }
-
-        default: break;
+    static const LocalisedStringTable nouns
+    {
+        NEEDS_TRANS ("tile"),
+        NEEDS_TRANS ("dirt"),
+        NEEDS_TRANS ("grass"),
+        NEEDS_TRANS ("brick"),
+        NEEDS_TRANS ("glass"),
+        NEEDS_TRANS ("wood"),
+        NEEDS_TRANS ("metal"),
+        NEEDS_TRANS ("vinyl"),
+        NEEDS_TRANS ("stone"),
+        NEEDS_TRANS ("marble"),
+        NEEDS_TRANS ("concrete"),
+        NEEDS_TRANS ("cement"),
+        NEEDS_TRANS ("plastic"),
+        NEEDS_TRANS ("ice"),
+        NEEDS_TRANS ("ooze")
     };
 
-    jassertfalse;
-    return {};
+    static const LocalisedStringTable adjectives
+    {
+        NEEDS_TRANS ("tiled"),
+        NEEDS_TRANS ("dirty"),
+        NEEDS_TRANS ("grassy"),
+        NEEDS_TRANS ("brick"),
+        NEEDS_TRANS ("glass"),
+        NEEDS_TRANS ("wooden"),
+        NEEDS_TRANS ("metallic"),
+        NEEDS_TRANS ("vinyl"),
+        NEEDS_TRANS ("stone"),
+        NEEDS_TRANS ("marbled"),
+        NEEDS_TRANS ("concrete"),
+        NEEDS_TRANS ("cemented"),
+        NEEDS_TRANS ("plastic"),
+        NEEDS_TRANS ("iced"),
+        NEEDS_TRANS ("ooze")
+    };
+
+    jassert (nouns.size() == static_cast<int> (Material::numMaterials));
+
+    return (asAdjective ? adjectives : nouns)[static_cast<int> (materialType)];
 }
 
 //==============================================================================
@@ -655,25 +904,22 @@ enum class MoveType
 };
 
 /** */
-inline String toString (MoveType moveType)
+inline const String& toString (MoveType moveType)
 {
-    switch (moveType)
-    {
-        case MoveType::normal:      return TRANS ("Normal");
-        case MoveType::earth:       return TRANS ("Earth");
-        case MoveType::wind:        return TRANS ("Wind");
-        case MoveType::water:       return TRANS ("Water");
-        case MoveType::ice:         return TRANS ("Ice");
-        case MoveType::fire:        return TRANS ("Fire");
-        case MoveType::electric:    return TRANS ("Electric");
-        case MoveType::plasma:      return TRANS ("Plasma");
-        case MoveType::poison:      return TRANS ("Poison");
-
-        default: break;
+    static const LocalisedStringTable names
+    {
+        NEEDS_TRANS ("Normal"),
+        NEEDS_TRANS ("Earth"),
+        NEEDS_TRANS ("Wind"),
+        NEEDS_TRANS ("Water"),
+        NEEDS_TRANS ("Ice"),
+        NEEDS_TRANS ("Fire"),
+        NEEDS_TRANS ("Electric"),
+        NEEDS_TRANS ("Plasma"),
+        NEEDS_TRANS ("Poison")
     };
 
-    jassertfalse;
-    return {};
+    return names[static_cast<int> (moveType)];
 }
 
 //==============================================================================
@@ -689,20 +935,17 @@ enum class MoveCategory
 };
 
 /** */
-inline String toString (MoveCategory moveType)
+inline const String& toString (MoveCategory moveCategory)
 {
-    switch (moveType)
+    static const LocalisedStringTable names
     {
-        case MoveCategory::unknown:     return TRANS ("Unknown");
-        case MoveCategory::physical:    return TRANS ("Physical");
-        case MoveCategory::special:     return TRANS ("Special");
-        case MoveCategory::status:      return TRANS ("Status");
-
-        default: break;
+        NEEDS_TRANS ("Unknown"),
+        NEEDS_TRANS ("Physical"),
+        NEEDS_TRANS ("Special"),
+        NEEDS_TRANS ("Status")
     };
 
-    jassertfalse;
-    return {};
+    return names[static_cast<int> (moveCategory)];
 }
 
 //==============================================================================
@@ -741,41 +984,38 @@ enum class Nature
 };
 
 /** */
-inline String toString (Nature nature)
+inline const String& toString (Nature nature)
 {
-    switch (nature)
-    {
-        case Nature::adamant:   return TRANS ("Adamant");
-        case Nature::bashful:   return TRANS ("Bashful");
-        case Nature::bold:      return TRANS ("Bold");
-        case Nature::brave:     return TRANS ("Brave");
-        case Nature::calm:      return TRANS ("Calm");
-        case Nature::careful:   return TRANS ("Careful");
-        case Nature::docile:    return TRANS ("Docile");
-        case Nature::gentle:    return TRANS ("Gentle");
-        case Nature::hardy:     return TRANS ("Hardy");
-        case Nature::hasty:     return TRANS ("Hasty");
-        case Nature::impish:    return TRANS ("Impish");
-        case Nature::jolly:     return TRANS ("Jolly");
-        case Nature::lax:       return TRANS ("Lax");
-        case Nature::lonely:    return TRANS ("Lonely");
-        case Nature::mild:      return TRANS ("Mild");
-        case Nature::modest:    return TRANS ("Modest");
-        case Nature::naive:     return TRANS ("Naive");
-        case Nature::naughty:   return TRANS ("Naughty");
-        case Nature::quiet:     return TRANS ("Quiet");
-        case Nature::quirky:    return TRANS ("Quirky");
-        case Nature::rash:      return TRANS ("Rash");
-        case Nature::relaxed:   return TRANS ("Relaxed");
-        case Nature::sassy:     return TRANS ("Sassy");
-        case Nature::serious:   return TRANS ("Serious");
-        case Nature::timid:     return TRANS ("Timid");
-
-        default: break;
+    static const LocalisedStringTable names
+    {
+        NEEDS_TRANS ("Adamant"),
+        NEEDS_TRANS ("Bashful"),
+        NEEDS_TRANS ("Bold"),
+        NEEDS_TRANS ("Brave"),
+        NEEDS_TRANS ("Calm"),
+        NEEDS_TRANS ("Careful"),
+        NEEDS_TRANS ("Docile"),
+        NEEDS_TRANS ("Gentle"),
+        NEEDS_TRANS ("Hardy"),
+        NEEDS_TRANS ("Hasty"),
+        NEEDS_TRANS ("Impish"),
+        NEEDS_TRANS ("Jolly"),
+        NEEDS_TRANS ("Lax"),
+        NEEDS_TRANS ("Lonely"),
+        NEEDS_TRANS ("Mild"),
+        NEEDS_TRANS ("Modest"),
+        NEEDS_TRANS ("Naive"),
+        NEEDS_TRANS ("Naughty"),
+        NEEDS_TRANS ("Quiet"),
+        NEEDS_TRANS ("Quirky"),
+        NEEDS_TRANS ("Rash"),
+        NEEDS_TRANS ("Relaxed"),
+        NEEDS_TRANS ("Sassy"),
+        NEEDS_TRANS ("Serious"),
+        NEEDS_TRANS ("Timid")
     };
 
-    jassertfalse;
-    return {};
+    return names[static_cast<int> (nature)];
 }
 
 //==============================================================================
@@ -790,27 +1030,28 @@ enum class WeatherType
     rain,
     drizzle,
     snow,
-    stormy
+    stormy,
+
+    numWeatherTypes = stormy + 1
 };
 
 /** */
-inline String toString (WeatherType weatherType)
+inline const String& toString (WeatherType weatherType)
 {
-    switch (weatherType)
+    static const LocalisedStringTable names
     {
-        case WeatherType::clear:            return TRANS ("Clear");
-        case WeatherType::foggy:            return TRANS ("Foggy");
-        case WeatherType::partiallyCloudy:  return TRANS ("Partially Cloudy");
-        case WeatherType::cloudy:           return TRANS ("Cloudy");
-        case WeatherType::overcast:         return TRANS ("Overcasrt");
-        case WeatherType::rain:             return TRANS ("Rain");
-        case WeatherType::snow:             return TRANS ("Snow");
-
-        default: break;
+        NEEDS_TRANS ("Clear"),
+        NEEDS_TRANS ("Foggy"),
+        NEEDS_TRANS ("Partially Cloudy"),
+        NEEDS_TRANS ("Cloudy"),
+        NEEDS_TRANS ("Overcast"),
+        NEEDS_TRANS ("Rain"),
+        NEEDS_TRANS ("Drizzle"),
+        NEEDS_TRANS ("Snow"),
+        NEEDS_TRANS ("Stormy")
     };
 
-    jassertfalse;
-    return {};
+    return names[static_cast<int> (weatherType)];
 }
 
 //==============================================================================
@@ -897,29 +1138,38 @@ private:
 };
 
 /** @returns */
-inline String toString (Difficulty difficulty, bool asArray = false)
+inline const String& toString (Difficulty difficulty, bool asArray = false)
 {
-    if (difficulty.appliesToAll())
-        return TRANS ("Any");
-
-    if (! asArray)
+    // Every combination of flags, indexed by the flags themselves:
+    static const LocalisedStringTable names (1 << Difficulty::numFlags, [] (int flags)
     {
-        if (difficulty.appliesToEasy())     return TRANS ("Easy");
-        if (difficulty.appliesToMedium())   return TRANS ("Medium");
-        if (difficulty.appliesToHard())     return TRANS ("Hard");
+        static constexpr const char* flagNames[] =
+        {
+            NEEDS_TRANS ("Easy"),
+            NEEDS_TRANS ("Medium"),
+            NEEDS_TRANS ("Hard")
+        };
 
-        jassertfalse; // ???
-    }
+        static_assert (std::size (flagNames) == Difficulty::numFlags);
+
+        if (flags == 0)
+            return TRANS ("Any");
 
-    StringArray s;
+        StringArray s;
 
-    if (difficulty.appliesToEasy())     s.add (TRANS ("Easy"));
-    if (difficulty.appliesToMedium())   s.add (TRANS ("Medium"));
-    if (difficulty.appliesToHard())     s.add (TRANS ("Hard"));
+        for (int i = 0; i < Difficulty::numFlags; ++i)
+            if ((flags & (1 << i)) != 0)
+                s.add (TRANS (flagNames[i]));
 
-    jassert (! s.isEmpty());
+        return s.joinIntoString (", ");
+    });
 
-    return s.joinIntoString (", ");
+    auto flags = difficulty.getFlags() & ((1 << Difficulty::numFlags) - 1);
+
+    if (! asArray && flags != 0)
+        flags &= -flags; // Only the easiest difficulty.
+
+    return names[flags];
 }
 
 //==============================================================================
@@ -935,20 +1185,17 @@ enum class DoorLockState
 };
 
 /** @returns */
-inline String toString (DoorLockState doorLockState)
+inline const String& toString (DoorLockState doorLockState)
 {
-    switch (doorLockState)
+    static const LocalisedStringTable names
     {
-        case DoorLockState::unlocked:   return TRANS ("Unlocked");
-        case DoorLockState::needsKey:   return TRANS ("Needs Key");
-        case DoorLockState::needsSpell: return TRANS ("Needs Spell");
-        case DoorLockState::impassable: return TRANS ("Impassable");
-
-        default: break;
+        NEEDS_TRANS ("Unlocked"),
+        NEEDS_TRANS ("Needs Key"),
+        NEEDS_TRANS ("Needs Spell"),
+        NEEDS_TRANS ("Impassable")
     };
 
-    jassertfalse;
-    return {};
+    return names[static_cast<int> (doorLockState)];
 }
 
 //==============================================================================
@@ -964,18 +1211,15 @@ enum class WindowTileType
 };
 
 /** @returns */
-inline String toString (WindowTileType windowTileType)
+inline const String& toString (WindowTileType windowTileType)
 {
-    switch (windowTileType)
+    static const LocalisedStringTable names
     {
-        case WindowTileType::permanentlyOpen:           return TRANS ("Stuck Open");
-        case WindowTileType::permanentlyClosed:         return TRANS ("Stuck Closed");
-        case WindowTileType::openable:                  return TRANS ("Openable/Closeable");
-        case WindowTileType::openableWithUnlockableId:  return TRANS ("Openable (with ID)");
-
-        default: break;
+        NEEDS_TRANS ("Stuck Open"),
+        NEEDS_TRANS ("Stuck Closed"),
+        NEEDS_TRANS ("Openable/Closeable"),
+        NEEDS_TRANS ("Openable (with ID)")
     };
 
-    jassertfalse;
-    return {};
+    return names[static_cast<int> (windowTileType)];
 }
@@ -0,0 +1,139 @@
+//==============================================================================
+/** Finds the definitions of a GameMap, like the entries of its enemies and weapons,
+    by their key in constant time.
+
+    A definition's key is what the objects made from it store as their prototypeId
+    (see Prototype::getKey): its definitionKey, which doesn't change with the language
+    the content was loaded in, or its name if it doesn't have one.
+    If several definitions share a key, the first one, in category then definition order, is found.
+
+    Each definition also gets a SharedFallback, handed out with it by findPrototype(),
+    so that the objects made from a definition don't each have to listen to it.
+
+    Like StatusIndex, the index keeps itself current by listening to the definitions:
+    a definition being added is indexed on the spot, whereas a definition being removed
+    or changing its key makes the index rebuild itself, which should only happen while editing.
+
+    @see GameMap::findDefinition, Prototype
+*/
+class DefinitionIndex final : private ValueTree::Listener
+{
+public:
+    /** */
+    explicit DefinitionIndex (const ValueTree& definitionsState) :
+        definitions (definitionsState)
+    {
+        rebuild();
+        definitions.addListener (this);
+    }
+
+    /** */
+    ~DefinitionIndex() override
+    {
+        definitions.removeListener (this);
+    }
+
+    //==============================================================================
+    /** @returns the definition with the key, which will be invalid if there's no such definition. */
+    [[nodiscard]] ValueTree find (const String& key) const
+    {
+        return byKey[key].definition;
+    }
+
+    /** @returns the definition with the key along with its shared listener,
+        which will have an invalid definition if there's no such definition.
+    */
+    [[nodiscard]] Prototype findPrototype (const String& key) const
+    {
+        return byKey[key];
+    }
+
+    /** @returns the number of distinct keys. */
+    [[nodiscard]] int size() const noexcept { return byKey.size(); }
+
+private:
+    //==============================================================================
+    ValueTree definitions;
+    HashMap<String, Prototype> byKey;
+
+    //==============================================================================
+    /** Reuses the definition's listener from the previous index, if it was in it under the same key. */
+    void add (const ValueTree& definition, const HashMap<String, Prototype>* previous = nullptr)
+    {
+        const auto key = Prototype::getKey (definition);
+
+        if (key.isEmpty() || byKey.contains (key))
+            return;
+
+        if (previous != nullptr)
+        {
+            if (auto existing = (*previous)[key]; existing.definition == definition)
+            {
+                byKey.set (key, existing);
+                return;
+            }
+        }
+
+        byKey.set (key, { definition, new SharedFallback (definition) });
+    }
+
+    void addCategory (const ValueTree& category, const HashMap<String, Prototype>* previous = nullptr)
+    {
+        for (const auto& definition : category)
+            add (definition, previous);
+    }
+
+    void rebuild()
+    {
+        HashMap<String, Prototype> previous;
+        byKey.swapWith (previous);
+
+        for (const auto& category : definitions)
+            addCategory (category, &previous);
+    }
+
+    [[nodiscard]] bool isDefinition (const ValueTree& tree) const
+    {
+        return tree.getParent().getParent() == definitions;
+    }
+
+    //==============================================================================
+    void valueTreePropertyChanged (ValueTree& tree, const Identifier& id) override
+    {
+        if ((id == definitionKeyId || id == nameId) && isDefinition (tree))
+            rebuild();
+    }
+
+    void valueTreeChildAdded (ValueTree& parent, ValueTree& child) override
+    {
+        if (parent == definitions)
+            addCategory (child);
+        else if (parent.getParent() == definitions)
+        {
+            if (byKey.contains (Prototype::getKey (child)))
+                rebuild(); // It might have been inserted ahead of the one that was found.
+            else
+                add (child);
+        }
+    }
+
+    void valueTreeChildRemoved (ValueTree& parent, ValueTree&, int) override
+    {
+        if (parent == definitions || parent.getParent() == definitions)
+            rebuild();
+    }
+
+    void valueTreeChildOrderChanged (ValueTree& parent, int, int) override
+    {
+        if (parent == definitions || parent.getParent() == definitions)
+            rebuild();
+    }
+
+    void valueTreeRedirected (ValueTree&) override
+    {
+        rebuild();
+    }
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DefinitionIndex)
+};
@@ -37,6 +37,23 @@ public:
     {
     }
 
+    /** Constructs a world entity that inherits anything it doesn't override from its prototype. */
+    WorldEntity (const Prototype& prototypeToUse, UndoManager* undoManager = nullptr) :
+        WorldObject (prototypeToUse, undoManager)
+    {
+        setupPropAndCache (undoManager);
+    }
+
+    /** Wraps an existing state, like one that was saved and loaded,
+        along with the prototype it was made from, if any.
+        @see Prototype::of
+    */
+    WorldEntity (const ValueTree& existingState, const Prototype& prototypeToUse = {}, UndoManager* undoManager = nullptr) :
+        WorldObject (existingState, prototypeToUse, undoManager)
+    {
+        setupPropAndCache (undoManager);
+    }
+
     //==============================================================================
     /** */
     WorldEntity& setSubtype (String subtypeIdToUse, UndoManager* undoManager = nullptr)
@@ -99,7 +116,7 @@ public:
     /** */
     WorldEntity& addInventoryItem (const WorldObject& object, UndoManager* undoManager = nullptr)
     {
-        inventory.appendChild (object.getState(), undoManager);
+        attachChild (inventory, undoManager).appendChild (object.getState(), undoManager);
         return *this;
     }
 
@@ -144,11 +161,11 @@ public:
 
 private:
     //==============================================================================
-    CachedValue<String> subtype;
-    CachedValue<bool> npc;
-    CachedValue<double> direction, weight;
+    CachedProperty<String> subtype;
+    CachedProperty<bool> npc;
+    CachedProperty<double> direction, weight;
     ValueTree inventory { inventoryId };
-    CachedValue<Difficulty> difficulty;
+    CachedProperty<Difficulty> difficulty;
 
     //==============================================================================
     void setupPropAndCache (UndoManager* undoManager)
@@ -159,7 +176,7 @@ private:
         EngineObject::setupPropAndCache (subtype, subtypeId, {}, undoManager);
         EngineObject::setupPropAndCache (difficulty, difficultyId, {}, undoManager);
 
-        state.appendChild (inventory, undoManager);
+        adoptChild (inventory);
     }
 
     //==============================================================================
@@ -197,6 +214,13 @@ public:
         setupPropAndCache (undoManager);
     }
 
+    /** */
+    FightingMove (const Prototype& prototypeToUse, UndoManager* undoManager = nullptr) :
+        EngineObject (prototypeToUse, undoManager)
+    {
+        setupPropAndCache (undoManager);
+    }
+
     FightingMove (const FightingMove& other) :
         EngineObject (other.state.getType(), nullptr)
     {
@@ -213,7 +237,7 @@ public:
     #undef SET_GET
     #define SET_GET(Type, Name, varName, paramName) \
         private: \
-            CachedValue<Type> varName; \
+            CachedProperty<Type> varName; \
             \
         public: \
             FightingMove& set##Name (Type paramName, UndoManager* undoManager = nullptr) \
@@ -231,7 +255,7 @@ public:
     #undef SET_GET
     #define SET_GET(Name, varName) \
         private: \
-            CachedValue<int> varName; \
+            CachedProperty<int> varName; \
             \
         public: \
             FightingMove& set##Name (int new##Name, UndoManager* undoManager = nullptr) \
@@ -288,11 +312,30 @@ public:
     {
     }
 
+    /** Creates a fightable entity, such as an enemy, from a shared definition.
+        Only the stats that later differ from the definition's are stored in its own state.
+    */
+    FightableEntity (const Prototype& prototypeToUse, UndoManager* undoManager = nullptr) :
+        WorldEntity (prototypeToUse, undoManager)
+    {
+        setupPropAndCache (undoManager);
+    }
+
+    /** Wraps an existing state, like one that was saved and loaded,
+        along with the prototype it was made from, if any.
+        @see Prototype::of
+    */
+    FightableEntity (const ValueTree& existingState, const Prototype& prototypeToUse = {}, UndoManager* undoManager = nullptr) :
+        WorldEntity (existingState, prototypeToUse, undoManager)
+    {
+        setupPropAndCache (undoManager);
+    }
+
     //==============================================================================
     #undef SET_GET
     #define SET_GET(Type, Name, varName, paramName) \
         private: \
-            CachedValue<Type> varName; \
+            CachedProperty<Type> varName; \
             \
         public: \
             FightableEntity& set##Name (Type paramName, UndoManager* undoManager = nullptr) \
@@ -312,7 +355,7 @@ public:
     #undef SET_GET
     #define SET_GET(ClassName, varName) \
         private: \
-            CachedValue<ClassName> varName; \
+            CachedProperty<ClassName> varName; \
             \
         public: \
             void set##ClassName (ClassName new##ClassName, UndoManager* undoManager = nullptr) \
@@ -332,7 +375,7 @@ public:
     #undef SET_GET
     #define SET_GET(ClassName, varName) \
         private: \
-            CachedValue<int> varName; \
+            CachedProperty<int> varName; \
             \
         public: \
             void set##ClassName (int new##ClassName, UndoManager* undoManager = nullptr) \
@@ -372,7 +415,7 @@ public:
     /** */
     FightableEntity& addFightingMove (const FightingMove& fightingMove, UndoManager* undoManager = nullptr)
     {
-        fightingMoves.appendChild (fightingMove.getState(), undoManager);
+        attachChild (fightingMoves, undoManager).appendChild (fightingMove.getState(), undoManager);
         return *this;
     }
 
@@ -411,7 +454,7 @@ private:
         EngineObject::setupPropAndCache (specialDefense, specialDefenseId, 5, undoManager);
         EngineObject::setupPropAndCache (speed, speedId, 6, undoManager);
 
-        state.appendChild (fightingMoves, undoManager);
+        adoptChild (fightingMoves);
     }
 
     //==============================================================================
@@ -487,15 +530,30 @@ public:
                 UndoManager* undoManager = nullptr) :
         WorldObject (tileId,
                      interactionId,
-                     undoManager),
-        type (state, typeId, undoManager, static_cast<int> (Type::floor)),
-        material (state, materialId, undoManager, static_cast<int> (Material::stone)),
-        colour (state, colourId, undoManager, Colours::transparentBlack)
+                     undoManager)
     {
-        state.appendChild (inventory, undoManager);
+        EngineObject::setupPropAndCache (type, typeId, static_cast<int> (Type::floor), undoManager);
+        EngineObject::setupPropAndCache (material, materialId, static_cast<int> (Material::stone), undoManager);
+        EngineObject::setupPropAndCache (colour, colourId, Colours::transparentBlack, undoManager);
+
         setType (tileType, undoManager);
     }
 
+    /** Wraps the existing state of a tile of any type, like when promoting
+        the tiles of a saved GameMap again.
+    */
+    explicit EngineTile (const ValueTree& existingState, UndoManager* undoManager = nullptr) :
+        WorldObject (existingState, undoManager)
+    {
+        jassert (existingState.hasType (tileId));
+
+        EngineObject::setupPropAndCache (type, typeId, static_cast<int> (Type::floor), undoManager);
+        EngineObject::setupPropAndCache (material, materialId, static_cast<int> (Material::stone), undoManager);
+        EngineObject::setupPropAndCache (colour, colourId, Colours::transparentBlack, undoManager);
+
+        adoptChild (inventory);
+    }
+
     //==============================================================================
     /** @returns */
     [[nodiscard]] Type getType() const noexcept                                 { return static_cast<Type> (type.get()); }
@@ -523,7 +581,7 @@ public:
     /** */
     EngineTile& addInventoryItem (const WorldObject& object, UndoManager* undoManager = nullptr)
     {
-        inventory.appendChild (object.getState(), undoManager);
+        attachChild (inventory, undoManager).appendChild (object.getState(), undoManager);
         return *this;
     }
 
@@ -543,16 +601,84 @@ public:
 
 private:
     //==============================================================================
-    CachedValue<int> type, material;
-    CachedValue<Colour> colour;
+    CachedProperty<int> type, material;
+    CachedProperty<Colour> colour;
     ValueTree inventory { inventoryId };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EngineTile)
 };
 
+//==============================================================================
+/** Eliminates boilerplate in linking a tile to a position on another GameMap,
+    like a door leading to the next room or stairs leading to another floor.
+
+    A tile without a destination map isn't linked to anything.
+
+    @see DoorTile, StairTile, WorldManager
+*/
+class MapLink
+{
+public:
+    /** */
+    MapLink (ValueTree& sourceState) :
+        linkState (sourceState)
+    {
+    }
+
+    /** */
+    virtual ~MapLink() = default;
+
+    //==============================================================================
+    /** @returns the name of the linked map, or an empty string if there's no link. */
+    [[nodiscard]] String getDestinationMap() const                  { return getDestinationMap (linkState); }
+    /** @returns the position on the linked map where the player should arrive. */
+    [[nodiscard]] Point<int> getDestinationPosition() const         { return getDestinationPosition (linkState); }
+    /** @returns */
+    [[nodiscard]] bool hasDestination() const                       { return hasDestination (linkState); }
+
+    /** */
+    void setDestination (const String& mapName, Point<int> position, UndoManager* undoManager = nullptr)
+    {
+        jassert (mapName.isNotEmpty());
+
+        linkState.setProperty (destinationMapId, mapName, undoManager);
+        linkState.setProperty (destinationPositionId, PropertyConverter<Point<int>>::toVar (position), undoManager);
+    }
+
+    /** */
+    void clearDestination (UndoManager* undoManager = nullptr)
+    {
+        linkState.removeProperty (destinationMapId, undoManager);
+        linkState.removeProperty (destinationPositionId, undoManager);
+    }
+
+    //==============================================================================
+    /** @returns the name of the map the state links to, without needing to wrap the state in a tile. */
+    [[nodiscard]] static String getDestinationMap (const ValueTree& state)      { return state[destinationMapId].toString(); }
+    /** @returns */
+    [[nodiscard]] static bool hasDestination (const ValueTree& state)           { return getDestinationMap (state).isNotEmpty(); }
+
+    /** @returns the arrival position the state links to, without needing to wrap the state in a tile. */
+    [[nodiscard]] static Point<int> getDestinationPosition (const ValueTree& state)
+    {
+        if (const auto* v = state.getPropertyPointer (destinationPositionId))
+            return PropertyConverter<Point<int>>::fromVar (*v);
+
+        return {};
+    }
+
+private:
+    //==============================================================================
+    ValueTree& linkState;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MapLink)
+};
+
 //==============================================================================
 /** */
-class StairTile final : public EngineTile
+class StairTile final : public EngineTile,
+                        public MapLink
 {
 public:
     /** */
@@ -568,8 +694,9 @@ public:
                StringRef interactionId = {},
                UndoManager* undoManager = nullptr) :
         EngineTile (Type::stairs, interactionId, undoManager),
-        direction (state, directionId, undoManager, static_cast<int> (Direction::up))
+        MapLink (state)
     {
+        EngineObject::setupPropAndCache (direction, directionId, static_cast<int> (Direction::up), undoManager);
         setDirection (startDirection, undoManager);
     }
 
@@ -581,7 +708,7 @@ public:
 
 private:
     //==============================================================================
-    CachedValue<int> direction;
+    CachedProperty<int> direction;
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StairTile)
@@ -658,9 +785,15 @@ private:
 };
 
 //==============================================================================
-/** */
+/** A door, which can be locked and can lead to another GameMap.
+
+    A door can also lock itself again once it's been left unlocked for a while
+    (see setRelock), which needs it to be registered with a WorldTicker,
+    like any door promoted into a GameMap.
+*/
 class DoorTile final : public EngineTile,
-                       public Unlockable
+                       public Unlockable,
+                       public MapLink
 {
 public:
     //==============================================================================
@@ -671,9 +804,10 @@ public:
               UndoManager* undoManager = nullptr) :
         EngineTile (Type::door, interactionId, undoManager),
         Unlockable (state),
-        lockState (state, lockStateId, undoManager, static_cast<DoorLockStateType> (DoorLockState::unlocked)),
-        secret (state, secretId, undoManager, false)
+        MapLink (state)
     {
+        setupPropAndCache (undoManager);
+
         setLockState (startLockState, undoManager);
         setUnlockableIDs ({}, undoManager);
         setAsSecret (shouldBeSecret, undoManager);
@@ -691,6 +825,16 @@ public:
         setUnlockableID (unlockableID, undoManager);
     }
 
+    /** Wraps the existing state of a door, like when promoting the tiles of a saved GameMap again. */
+    explicit DoorTile (const ValueTree& existingState, UndoManager* undoManager = nullptr) :
+        EngineTile (existingState, undoManager),
+        Unlockable (state),
+        MapLink (state)
+    {
+        jassert (getType() == Type::door);
+        setupPropAndCache (undoManager);
+    }
+
     //==============================================================================
     /** @returns */
     [[nodiscard]] DoorLockState getLockState() const noexcept                           { return static_cast<DoorLockState> (lockState.get()); }
@@ -703,11 +847,67 @@ public:
     /** */
     void setAsSecret (bool shouldBeSecret, UndoManager* undoManager = nullptr)      { secret.setValue (shouldBeSecret, undoManager); }
 
+    //==============================================================================
+    /** Makes the door lock itself again, into the lock state, once it's been left unlocked
+        for the number of ticks. A delay of 0 or less stops it from doing so.
+    */
+    void setRelock (DoorLockState lockStateToReturnTo, int numTicks, UndoManager* undoManager = nullptr)
+    {
+        jassert (lockStateToReturnTo != DoorLockState::unlocked || numTicks <= 0);
+
+        relockState.setValue (static_cast<DoorLockStateType> (lockStateToReturnTo), undoManager);
+        relockDelay.setValue (numTicks, undoManager);
+    }
+
+    /** @returns the number of ticks the door stays unlocked for before locking itself again,
+        or 0 if it doesn't.
+    */
+    [[nodiscard]] int getRelockDelay() const noexcept                               { return jmax (0, relockDelay.get()); }
+    /** @returns the lock state the door goes back to. */
+    [[nodiscard]] DoorLockState getRelockState() const noexcept                     { return static_cast<DoorLockState> (relockState.get()); }
+
+    //==============================================================================
+    /** Schedules the door to lock itself again when it's been unlocked,
+        and does so once its timer is due and it's still unlocked.
+    */
+    void update() override
+    {
+        auto* worldTicker = getTicker();
+
+        if (worldTicker == nullptr || getRelockDelay() <= 0 || getLockState() != DoorLockState::unlocked)
+        {
+            relockTick = 0;
+            return;
+        }
+
+        if (relockTick == 0)
+        {
+            relockTick = worldTicker->getTick() + (uint64) getRelockDelay();
+            worldTicker->schedule (*this, getRelockDelay());
+        }
+        else if (worldTicker->getTick() >= relockTick)
+        {
+            relockTick = 0;
+            setLockState (getRelockState());
+        }
+    }
+
 private:
     //==============================================================================
     using DoorLockStateType = VariantConverter<DoorLockState>::Type;
-    CachedValue<DoorLockStateType> lockState;
-    CachedValue<bool> secret;
+    CachedProperty<DoorLockStateType> lockState, relockState;
+    CachedProperty<bool> secret;
+    CachedProperty<int> relockDelay;
+    uint64 relockTick = 0; // When the door is due to lock itself again, if it's unlocked.
+
+    //==============================================================================
+    void setupPropAndCache (UndoManager* undoManager)
+    {
+        EngineObject::setupPropAndCache (lockState, lockStateId, static_cast<DoorLockStateType> (DoorLockState::unlocked), undoManager);
+        EngineObject::setupPropAndCache (secret, secretId, false, undoManager);
+        EngineObject::setupPropAndCache (relockState, relockStateId, static_cast<DoorLockStateType> (DoorLockState::unlocked), undoManager);
+        EngineObject::setupPropAndCache (relockDelay, relockDelayId, 0, undoManager);
+    }
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DoorTile)
@@ -748,10 +948,11 @@ public:
                 StringRef interactionId = {},
                 UndoManager* undoManager = nullptr) :
         EngineTile (Type::window, interactionId, undoManager),
-        Unlockable (state),
-        subtype (state, windowTileSubtypeId, undoManager, static_cast<WindowTileTypeType> (WindowTileType::permanentlyClosed)),
-        opened (state, openedId, undoManager, false)
+        Unlockable (state)
     {
+        EngineObject::setupPropAndCache (subtype, windowTileSubtypeId, static_cast<WindowTileTypeType> (WindowTileType::permanentlyClosed), undoManager);
+        EngineObject::setupPropAndCache (opened, openedId, false, undoManager);
+
         setMaterial (material, undoManager);
         setColour (colour, undoManager);
         setSubtype (subtypeToUse, undoManager);
@@ -773,8 +974,8 @@ public:
 private:
     //==============================================================================
     using WindowTileTypeType = VariantConverter<WindowTileType>::Type;
-    CachedValue<WindowTileTypeType> subtype;
-    CachedValue<bool> opened;
+    CachedProperty<WindowTileTypeType> subtype;
+    CachedProperty<bool> opened;
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WindowTile)
@@ -0,0 +1,239 @@
+//==============================================================================
+/** The tiles of a TileGrid that can be seen from a point, like the player's position,
+    worked out by recursive shadowcasting.
+
+    Each of the 8 octants around the origin is scanned row by row outwards;
+    whenever an opaque tile is met, the rest of the octant is split around
+    the shadow it casts and the part that's still lit is scanned recursively.
+    Opaque tiles are themselves visible, so walls and closed doors show up
+    at the edges of what's seen.
+
+    Both the opacity read from the grid and the results are kept as per-chunk
+    bitboards (see TileGrid::ChunkBits), only for the chunks within the radius
+    around the origin, so a query is a couple of shifts and a mask.
+
+    Calling update() is cheap when nothing changed: the results are only
+    recomputed when the origin moves or the grid's opacity revision changes.
+
+    @see TileGrid, GameMap
+*/
+class FieldOfView final
+{
+public:
+    /** */
+    explicit FieldOfView (int radiusToUse = 16) :
+        radius (jlimit (0, maxRadius, radiusToUse))
+    {
+    }
+
+    //==============================================================================
+    /** The furthest that can be seen, in tiles. */
+    static constexpr int maxRadius = 64;
+
+    /** @returns the furthest that can be seen, in tiles. */
+    [[nodiscard]] int getRadius() const noexcept { return radius; }
+
+    /** Changes the furthest that can be seen, in tiles, recomputing on the next update. */
+    void setRadius (int newRadius)
+    {
+        newRadius = jlimit (0, maxRadius, newRadius);
+
+        if (radius != newRadius)
+        {
+            radius = newRadius;
+            clear();
+        }
+    }
+
+    //==============================================================================
+    /** Recomputes what can be seen from the origin, unless neither the origin
+        nor the opacity of the grid's tiles have changed since the last time.
+
+        @returns true if it was recomputed.
+    */
+    bool update (const TileGrid& grid, Point<int> newOrigin)
+    {
+        if (isValid && origin == newOrigin && revision == grid.getOpacityRevision())
+            return false;
+
+        origin = newOrigin;
+        revision = grid.getOpacityRevision();
+        isValid = true;
+        compute (grid);
+        return true;
+    }
+
+    /** Forgets what was seen, such as when the player leaves the map. */
+    void clear()
+    {
+        isValid = false;
+        numVisible = 0;
+        numChunksWide = numChunksHigh = 0;
+        visible.clear();
+    }
+
+    //==============================================================================
+    /** @returns the point that sight is worked out from. */
+    [[nodiscard]] Point<int> getOrigin() const noexcept         { return origin; }
+    /** @returns the number of tiles that can be seen, including any empty positions. */
+    [[nodiscard]] int getNumVisible() const noexcept            { return numVisible; }
+
+    /** @returns true if the position can be seen. */
+    [[nodiscard]] bool isVisible (Point<int> position) const noexcept
+    {
+        const auto chunk = TileGrid::toChunk (position) - firstChunk;
+
+        if (! isPositiveAndBelow (chunk.x, numChunksWide) || ! isPositiveAndBelow (chunk.y, numChunksHigh))
+            return false;
+
+        return (getRow (visible, position) & getBit (position)) != 0;
+    }
+
+    /** Calls the callback with each position that can be seen, chunk by chunk.
+        The callback's signature is: void (Point<int>)
+    */
+    template<typename Callback>
+    void forEachVisibleTile (Callback&& callback) const
+    {
+        for (int cy = 0; cy < numChunksHigh; ++cy)
+        {
+            for (int cx = 0; cx < numChunksWide; ++cx)
+            {
+                const auto& bits = visible[(size_t) (cy * numChunksWide + cx)];
+                const auto chunkOrigin = (firstChunk + Point<int> (cx, cy)) * TileGrid::chunkSize;
+
+                for (int row = 0; row < TileGrid::chunkSize; ++row)
+                {
+                    for (auto rowBits = bits[(size_t) row]; rowBits != 0; rowBits &= rowBits - 1)
+                        callback (chunkOrigin + Point<int> (std::countr_zero (rowBits), row));
+                }
+            }
+        }
+    }
+
+private:
+    //==============================================================================
+    int radius = 16;
+    Point<int> origin;
+    uint32 revision = 0;
+    bool isValid = false;
+    int numVisible = 0;
+
+    // The chunks around the origin, row by row, with a bitboard for each:
+    Point<int> firstChunk;
+    int numChunksWide = 0, numChunksHigh = 0;
+    std::vector<TileGrid::ChunkBits> opaque, visible;
+
+    //==============================================================================
+    /** @returns the row of the bitboards holding the position, which must be within the chunks around the origin. */
+    template<typename Bitboards>
+    [[nodiscard]] auto getRow (Bitboards& bitboards, Point<int> p) const noexcept -> decltype (bitboards[0][0])
+    {
+        const auto chunk = TileGrid::toChunk (p) - firstChunk;
+        return bitboards[(size_t) (chunk.y * numChunksWide + chunk.x)][(size_t) (p.y & (TileGrid::chunkSize - 1))];
+    }
+
+    /** @returns the bit of a bitboard's row for the position's column. */
+    [[nodiscard]] static uint32 getBit (Point<int> p) noexcept    { return 1u << (p.x & (TileGrid::chunkSize - 1)); }
+
+    [[nodiscard]] bool isOpaque (Point<int> p) const noexcept     { return (getRow (opaque, p) & getBit (p)) != 0; }
+
+    void setVisible (Point<int> p) noexcept
+    {
+        auto& row = getRow (visible, p);
+
+        if ((row & getBit (p)) == 0)
+        {
+            row |= getBit (p);
+            ++numVisible;
+        }
+    }
+
+    //==============================================================================
+    void compute (const TileGrid& grid)
+    {
+        firstChunk = TileGrid::toChunk (origin - Point<int> (radius, radius));
+        const auto lastChunk = TileGrid::toChunk (origin + Point<int> (radius, radius));
+        numChunksWide = lastChunk.x - firstChunk.x + 1;
+        numChunksHigh = lastChunk.y - firstChunk.y + 1;
+
+        const auto numChunks = (size_t) (numChunksWide * numChunksHigh);
+        opaque.resize (numChunks);
+        visible.assign (numChunks, {});
+        numVisible = 0;
+
+        for (int cy = 0; cy < numChunksHigh; ++cy)
+            for (int cx = 0; cx < numChunksWide; ++cx)
+                opaque[(size_t) (cy * numChunksWide + cx)] = grid.getOpaqueBits (firstChunk + Point<int> (cx, cy));
+
+        setVisible (origin);
+
+        // The transforms from an octant's (column, row) to the grid's (x, y):
+        static constexpr int xx[] = { 1,  0,  0, -1, -1,  0,  0,  1 };
+        static constexpr int xy[] = { 0,  1, -1,  0,  0, -1,  1,  0 };
+        static constexpr int yx[] = { 0,  1,  1,  0,  0, -1, -1,  0 };
+        static constexpr int yy[] = { 1,  0,  0,  1, -1,  0,  0, -1 };
+
+        for (int octant = 0; octant < 8; ++octant)
+            castLight (1, 1.0, 0.0, xx[octant], xy[octant], yx[octant], yy[octant]);
+    }
+
+    /** Scans an octant from the row outwards, between the start and end slopes. */
+    void castLight (int row, double startSlope, double endSlope, int xx, int xy, int yx, int yy)
+    {
+        if (startSlope < endSlope)
+            return;
+
+        const auto radiusSquared = radius * radius + radius; // Rounds the edge off a little.
+        auto nextStartSlope = startSlope;
+
+        for (int distance = row; distance <= radius; ++distance)
+        {
+            auto isBlocked = false;
+            const auto dy = -distance;
+
+            for (int dx = -distance; dx <= 0; ++dx)
+            {
+                const auto leftSlope = (dx - 0.5) / (dy + 0.5);
+                const auto rightSlope = (dx + 0.5) / (dy - 0.5);
+
+                if (startSlope < rightSlope)
+                    continue;
+
+                if (endSlope > leftSlope)
+                    break;
+
+                const auto p = origin + Point<int> (dx * xx + dy * xy, dx * yx + dy * yy);
+
+                if (dx * dx + dy * dy <= radiusSquared)
+                    setVisible (p);
+
+                const auto blocksSight = isOpaque (p);
+
+                if (isBlocked)
+                {
+                    if (blocksSight)
+                    {
+                        nextStartSlope = rightSlope;
+                        continue;
+                    }
+
+                    isBlocked = false;
+                    startSlope = nextStartSlope;
+                }
+                else if (blocksSight && distance < radius)
+                {
+                    isBlocked = true;
+                    castLight (distance + 1, startSlope, leftSlope, xx, xy, yx, yy);
+                    nextStartSlope = rightSlope;
+                }
+            }
+
+            if (isBlocked)
+                break;
+        }
+    }
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FieldOfView)
+};
@@ -1,43 +1,38 @@
-struct DarkEngineIdToNameMapper final
+namespace
 {
-    DarkEngineIdToNameMapper()
-    {
-        ids.minimiseStorageOverheads();
-        names.strings.minimiseStorageOverheads();
-
-        /** If you hit this, you probably added a new ID but didn't add a
-            translatable equivalent name for it.
-
-            This name will be used for display purposes, like when editing
-            game properties and children in ValueTree format.
-        */
-        jassert (ids.size() == names.size());
-    }
-
     #undef DARK_ENGINE_CREATE_ITEM
-    #define DARK_ENGINE_CREATE_ITEM(name) name##Id,
+    #define DARK_ENGINE_CREATE_ITEM(name) &name##Id,
 
-    Array<Identifier> ids =
+    /** The engine's IDs, in ordinal order. */
+    const Identifier* const engineIds[] =
     {
         DARK_ENGINE_CREATE_IDS (DARK_ENGINE_CREATE_ITEM)
     };
 
     #undef DARK_ENGINE_CREATE_ITEM
 
-    StringArray names =
+    /** The untranslated display names of the engine's IDs, in ordinal order.
+
+        These are used for display purposes, like when editing
+        game properties and children in ValueTree format.
+    */
+    constexpr const char* equivalentNames[] =
     {
         NEEDS_TRANS ("Accuracy"),
         NEEDS_TRANS ("Attack"),
         NEEDS_TRANS ("Colour"),
         NEEDS_TRANS ("Defense"),
+        NEEDS_TRANS ("Definition Key"),
         NEEDS_TRANS ("Definitions"),
         NEEDS_TRANS ("Description"),
+        NEEDS_TRANS ("Destination Map"),
+        NEEDS_TRANS ("Destination Position"),
         NEEDS_TRANS ("Difficulty"),
         NEEDS_TRANS ("Dimensions"),
         NEEDS_TRANS ("Direction"),
         NEEDS_TRANS ("Enemies"),
         NEEDS_TRANS ("Experience"),
-        NEEDS_TRANS ("Eighting Moves"),
+        NEEDS_TRANS ("Fighting Moves"),
         NEEDS_TRANS ("Game Map"),
         NEEDS_TRANS ("Hit Points"),
         NEEDS_TRANS ("Inanimate Objects"),
@@ -64,6 +59,9 @@ struct DarkEngineIdToNameMapper final
         NEEDS_TRANS ("Power"),
         NEEDS_TRANS ("Power Points"),
         NEEDS_TRANS ("Priority"),
+        NEEDS_TRANS ("Prototype"),
+        NEEDS_TRANS ("Relock Delay"),
+        NEEDS_TRANS ("Relock State"),
         NEEDS_TRANS ("Screen Icon"),
         NEEDS_TRANS ("Secret"),
         NEEDS_TRANS ("Special Attack"),
@@ -72,6 +70,8 @@ struct DarkEngineIdToNameMapper final
         NEEDS_TRANS ("Status Condition"),
         NEEDS_TRANS ("Subtype"),
         NEEDS_TRANS ("Tile"),
+        NEEDS_TRANS ("Tile Chunk"),
+        NEEDS_TRANS ("Tile Grid"),
         NEEDS_TRANS ("Type"),
         NEEDS_TRANS ("Unlockable IDs"),
         NEEDS_TRANS ("Weak-Against Type"),
@@ -81,16 +81,67 @@ struct DarkEngineIdToNameMapper final
         NEEDS_TRANS ("Window Tile Subtype"),
         NEEDS_TRANS ("World")
     };
-};
 
-String getEquivalentName (const Identifier& id)
+    /** If this fails, you probably added a new ID but didn't add a
+        translatable equivalent name for it, or not in the same order.
+    */
+    static_assert (std::size (equivalentNames) == static_cast<size_t> (numIds));
+
+    //==============================================================================
+    /** Maps an Identifier to its ordinal by the address of its pooled name,
+        since Identifiers with the same name always share it.
+    */
+    class OrdinalLookup final
+    {
+    public:
+        OrdinalLookup()
+        {
+            ordinals.reserve ((size_t) numIds);
+
+            for (int i = 0; i < numIds; ++i)
+                ordinals.emplace (getKey (*engineIds[i]), i);
+        }
+
+        [[nodiscard]] int find (const Identifier& id) const noexcept
+        {
+            if (const auto iter = ordinals.find (getKey (id)); iter != ordinals.end())
+                return iter->second;
+
+            return -1;
+        }
+
+    private:
+        std::unordered_map<const void*, int> ordinals;
+
+        [[nodiscard]] static const void* getKey (const Identifier& id) noexcept
+        {
+            return id.getCharPointer().getAddress();
+        }
+    };
+}
+
+//==============================================================================
+int getOrdinal (const Identifier& id) noexcept
+{
+    static const OrdinalLookup lookup;
+    return lookup.find (id);
+}
+
+const Identifier& getIdentifier (IdOrdinal ordinal) noexcept
 {
-    static const DarkEngineIdToNameMapper mapper;
+    jassert (isPositiveAndBelow (static_cast<int> (ordinal), numIds));
+    return *engineIds[static_cast<size_t> (ordinal)];
+}
 
-    jassert (mapper.ids.contains (id));
+const String& getEquivalentName (const Identifier& id)
+{
+    static const LocalisedStringTable names (numIds, [] (int index)
+    {
+        return TRANS (equivalentNames[index]);
+    });
 
-    if (const int index = mapper.ids.indexOf (id); index >= 0)
-        return TRANS (mapper.names.strings.getUnchecked (index));
+    const auto ordinal = getOrdinal (id);
 
-    return {};
+    jassert (ordinal >= 0);
+    return names[ordinal];
 }
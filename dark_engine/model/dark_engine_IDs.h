@@ -5,8 +5,11 @@
     X (attack) \
     X (colour) \
     X (defense) \
+    X (definitionKey) \
     X (definitions) \
     X (description) \
+    X (destinationMap) \
+    X (destinationPosition) \
     X (difficulty) \
     X (dimensions) \
     X (direction) \
@@ -39,6 +42,9 @@
     X (power) \
     X (powerPoints) \
     X (priority) \
+    X (prototype) \
+    X (relockDelay) \
+    X (relockState) \
     X (screenIcon) \
     X (secret) \
     X (specialAttack) \
@@ -47,6 +53,8 @@
     X (statusCondition) \
     X (subtype) \
     X (tile) \
+    X (tileChunk) \
+    X (tileGrid) \
     X (type) \
     X (unlockableIDs) \
     X (weakAgainstType) \
@@ -59,5 +67,38 @@
 DARK_ENGINE_CREATE_IDS (CREATE_INLINE_IDENTIFIER)
 
 //==============================================================================
-/** @returns */
-String getEquivalentName (const Identifier&);
+/** The position of each of the engine's IDs within DARK_ENGINE_CREATE_IDS,
+    known at compile time, for indexing tables of per-ID data.
+
+    @see getOrdinal, getIdentifier
+*/
+enum class IdOrdinal
+{
+    #undef DARK_ENGINE_CREATE_ITEM
+    #define DARK_ENGINE_CREATE_ITEM(name) name,
+
+    DARK_ENGINE_CREATE_IDS (DARK_ENGINE_CREATE_ITEM)
+
+    #undef DARK_ENGINE_CREATE_ITEM
+
+    numIds
+};
+
+/** The number of the engine's IDs. */
+constexpr int numIds = static_cast<int> (IdOrdinal::numIds);
+
+/** @returns the ordinal of one of the engine's IDs, in constant time,
+    or -1 if the ID isn't one of the engine's.
+*/
+[[nodiscard]] int getOrdinal (const Identifier&) noexcept;
+
+/** @returns the engine's ID with the ordinal. */
+[[nodiscard]] const Identifier& getIdentifier (IdOrdinal) noexcept;
+
+//==============================================================================
+/** @returns the display name of one of the engine's IDs, in the current language.
+
+    This is a constant time lookup into a LocalisedStringTable,
+    so it neither translates nor allocates anything.
+*/
+[[nodiscard]] const String& getEquivalentName (const Identifier&);
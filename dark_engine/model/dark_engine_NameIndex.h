@@ -0,0 +1,464 @@
+//==============================================================================
+/** An inverted index of the words in the names, subtypes and interaction IDs
+    of the direct children of a world ValueTree, for resolving the nouns typed
+    by the player (eg: "pick up the rusty key") to the objects they mean.
+
+    Each field is split into words at anything that isn't a letter or a digit
+    (so "Rusty Key", "rusty_key" and "rusty-key" are all "rusty" and "key"),
+    and each word is keyed by its case-folded hash, the same one VerbTable uses.
+    A lookup only visits the objects that share a word with the query,
+    never lower-cases anything, and doesn't allocate once its scratch space
+    and the caller's results have grown to size.
+
+    Objects made from a Prototype index the fields they inherit from it.
+
+    Like SpatialIndex, the index keeps itself current by listening to the world
+    for children being added, removed or reordered, and to each child for changes
+    to the indexed properties.
+
+    @see GameMap, WorldObject, WorldEntity, CommandTokenizer
+*/
+class NameIndex final : private ValueTree::Listener
+{
+public:
+    /** Finds a definition by its key, for objects made from a Prototype.
+        @see GameMap::findDefinition
+    */
+    using DefinitionFinder = Prototype::DefinitionFinder;
+
+    /** */
+    NameIndex (const ValueTree& worldState, DefinitionFinder definitionFinder = nullptr) :
+        world (worldState),
+        findDefinition (std::move (definitionFinder))
+    {
+        items.ensureStorageAllocated (world.getNumChildren());
+
+        for (const auto& child : world)
+            insertItem (items.size(), child);
+
+        world.addListener (this);
+    }
+
+    /** */
+    ~NameIndex() override
+    {
+        world.removeListener (this);
+    }
+
+    //==============================================================================
+    /** Where a word of the query was found, from the most to the least telling. */
+    enum class Field
+    {
+        name,
+        interactionId,
+        subtype
+    };
+
+    /** An object that matched at least one word of a query. */
+    struct Match final
+    {
+        ValueTree state;
+        int score = 0;              // Higher is better.
+        int numWordsMatched = 0;    // The number of the query's words that this object has.
+    };
+
+    //==============================================================================
+    /** @returns the number of world children being tracked. */
+    [[nodiscard]] int getNumObjects() const noexcept { return items.size(); }
+
+    /** Finds the objects that share any of the words, best first.
+
+        The words are split up like the indexed fields are, and filler words
+        like "the" and "a" are ignored.
+
+        An object scores more for each word found in its name than in its
+        interaction ID, and more for that than in its subtype. An object whose
+        name is exactly the query outranks the rest, and among equal scores,
+        the object with the fewest words in its name (ie: the most specific one)
+        comes first, and then the one that comes first in the world.
+
+        @param words    The words to look for, like the tokens after a command's verb.
+                        @see CommandTokenizer::getTokens
+        @param results  Cleared, then filled with the matches.
+                        Reusing the same array avoids allocating once it's big enough.
+        @param within   If not empty, only objects whose dimensions intersect this area are returned.
+
+        @returns the number of matches.
+    */
+    int findMatches (std::span<const std::string_view> words, Array<Match>& results,
+                     Rectangle<int> within = {}) const
+    {
+        results.clearQuick();
+
+        if (items.isEmpty())
+            return 0;
+
+        if (++visitStamp == 0) // Wrapped around, so forget all previous visits.
+        {
+            for (auto* item : items)
+                item->lastVisit = 0;
+
+            visitStamp = 1;
+        }
+
+        touched.clearQuick();
+        int numQueryWords = 0;
+
+        for (const auto& token : words)
+        {
+            forEachWord (token, [&] (std::string_view word)
+            {
+                if (isFillerWord (word))
+                    return;
+
+                ++numQueryWords;
+                scoreWord (word, numQueryWords);
+            });
+        }
+
+        if (! within.isEmpty())
+            touched.removeIf ([&] (const Item* item) { return ! readBounds (item->tree).intersects (within); });
+
+        for (auto* item : touched)
+            if (item->numNameWordsMatched == numQueryWords && item->numNameWords == numQueryWords)
+                item->score += exactNameBonus;
+
+        std::sort (touched.begin(), touched.end(), [] (const Item* a, const Item* b)
+        {
+            if (a->score != b->score)
+                return a->score > b->score;
+
+            if (a->numNameWords != b->numNameWords)
+                return a->numNameWords < b->numNameWords;
+
+            return a->order < b->order;
+        });
+
+        results.ensureStorageAllocated (touched.size());
+
+        for (const auto* item : touched)
+            results.add ({ item->tree, item->score, item->numWordsMatched });
+
+        return results.size();
+    }
+
+    /** @returns true if the best two matches are too close to tell apart,
+        meaning that the player should be asked which one they meant.
+    */
+    [[nodiscard]] static bool isAmbiguous (const Array<Match>& sortedMatches) noexcept
+    {
+        return sortedMatches.size() > 1
+            && sortedMatches.getReference (0).score == sortedMatches.getReference (1).score;
+    }
+
+private:
+    //==============================================================================
+    static constexpr int exactNameBonus = 100;
+
+    [[nodiscard]] static constexpr int getWeight (Field field) noexcept
+    {
+        switch (field)
+        {
+            case Field::name:           return 8;
+            case Field::interactionId:  return 4;
+            case Field::subtype:        return 2;
+            default:                    break;
+        }
+
+        return 0;
+    }
+
+    //==============================================================================
+    struct Word final
+    {
+        std::string text;
+        Field field = Field::name;
+    };
+
+    /** Mirrors a single child of the world, listening to it directly
+        so that a change of name can be reindexed without a search.
+    */
+    struct Item final : private ValueTree::Listener
+    {
+        Item (NameIndex& o, const ValueTree& t) :
+            owner (o),
+            tree (t)
+        {
+            tree.addListener (this);
+        }
+
+        ~Item() override
+        {
+            tree.removeListener (this);
+        }
+
+        void valueTreePropertyChanged (ValueTree& t, const Identifier& id) override
+        {
+            if (t == tree && isIndexedProperty (id))
+                owner.reindex (*this);
+        }
+
+        NameIndex& owner;
+        ValueTree tree;
+        std::vector<Word> words;
+        int numNameWords = 0;
+        int order = 0;
+
+        mutable uint32 lastVisit = 0;
+        mutable int score = 0, numWordsMatched = 0, numNameWordsMatched = 0, lastQueryWord = 0;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Item)
+    };
+
+    /** An occurrence of a word, as the index of the word within its item. */
+    struct Posting final
+    {
+        Item* item = nullptr;
+        int wordIndex = 0;
+    };
+
+    /** The keys are already hashes, so are used as they are. */
+    struct IdentityHash final
+    {
+        size_t operator() (uint32 h) const noexcept { return h; }
+    };
+
+    //==============================================================================
+    ValueTree world;
+    const DefinitionFinder findDefinition;
+    OwnedArray<Item> items; // Kept in the same order as the world's children.
+    std::unordered_map<uint32, Array<Posting>, IdentityHash> postings;
+
+    mutable uint32 visitStamp = 0;
+    mutable Array<Item*> touched;
+
+    //==============================================================================
+    [[nodiscard]] static bool isIndexedProperty (const Identifier& id) noexcept
+    {
+        return id == nameId || id == subtypeId || id == interactionIdId || id == prototypeId;
+    }
+
+    [[nodiscard]] static constexpr bool isWordCharacter (char c) noexcept
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+            || static_cast<uint8> (c) >= 0x80; // Keeps multi-byte UTF-8 in one piece.
+    }
+
+    /** Calls the callback with each word of the text. */
+    template<typename Callback>
+    static void forEachWord (std::string_view text, Callback&& callback)
+    {
+        size_t i = 0;
+
+        while (i < text.size())
+        {
+            while (i < text.size() && ! isWordCharacter (text[i]))
+                ++i;
+
+            const auto start = i;
+
+            while (i < text.size() && isWordCharacter (text[i]))
+                ++i;
+
+            if (i > start)
+                callback (text.substr (start, i - start));
+        }
+    }
+
+    [[nodiscard]] static bool isFillerWord (std::string_view word) noexcept
+    {
+        constexpr std::string_view fillerWords[] = { "a", "an", "the", "some", "that", "this" };
+
+        for (const auto& filler : fillerWords)
+            if (VerbHashing::equalsIgnoringCase (filler, word))
+                return true;
+
+        return false;
+    }
+
+    [[nodiscard]] static Rectangle<int> readBounds (const ValueTree& tree)
+    {
+        if (const auto* v = tree.getPropertyPointer (dimensionsId))
+            return PropertyConverter<Rectangle<int>>::fromVar (*v);
+
+        return {};
+    }
+
+    [[nodiscard]] static bool equalsIgnoringCase (std::string_view a, std::string_view b) noexcept
+    {
+        if (a.size() != b.size())
+            return false;
+
+        for (size_t i = 0; i < a.size(); ++i)
+            if (VerbHashing::toLower (a[i]) != VerbHashing::toLower (b[i]))
+                return false;
+
+        return true;
+    }
+
+    //==============================================================================
+    /** Adds the word's weight to every object that has it, at most once per field and query word. */
+    void scoreWord (std::string_view word, int queryWordNumber) const
+    {
+        const auto bucket = postings.find (VerbHashing::hash (word));
+        if (bucket == postings.end())
+            return;
+
+        for (const auto& posting : bucket->second)
+        {
+            auto* item = posting.item;
+            const auto& indexed = item->words[(size_t) posting.wordIndex];
+
+            if (! equalsIgnoringCase (indexed.text, word))
+                continue; // A hash collision.
+
+            if (item->lastVisit != visitStamp)
+            {
+                item->lastVisit = visitStamp;
+                item->score = 0;
+                item->numWordsMatched = 0;
+                item->numNameWordsMatched = 0;
+                item->lastQueryWord = 0;
+                touched.add (item);
+            }
+
+            if (item->lastQueryWord != queryWordNumber)
+            {
+                // Only the best field counts for each word of the query,
+                // and the name's words come first, so the first posting is it.
+                item->lastQueryWord = queryWordNumber;
+                item->score += getWeight (indexed.field);
+                ++item->numWordsMatched;
+
+                if (indexed.field == Field::name)
+                    ++item->numNameWordsMatched;
+            }
+        }
+    }
+
+    //==============================================================================
+    /** @returns the property, or the one inherited from the object's prototype. */
+    [[nodiscard]] String readField (const ValueTree& tree, const ValueTree& definition, const Identifier& id) const
+    {
+        if (const auto* v = tree.getPropertyPointer (id))
+            return v->toString();
+
+        if (definition.isValid())
+            return definition[id].toString();
+
+        return {};
+    }
+
+    void addWords (Item& item, const String& text, Field field)
+    {
+        const auto utf8 = std::string_view (text.toRawUTF8(), text.getNumBytesAsUTF8());
+
+        forEachWord (utf8, [&] (std::string_view word)
+        {
+            // Queries drop these, so a name like "The Old Key" must be as long as "old key":
+            if (isFillerWord (word))
+                return;
+
+            item.words.push_back ({ std::string (word), field });
+
+            if (field == Field::name)
+                ++item.numNameWords;
+        });
+    }
+
+    void addToPostings (Item& item)
+    {
+        for (int i = 0; i < (int) item.words.size(); ++i)
+            postings[VerbHashing::hash (item.words[(size_t) i].text)].add ({ &item, i });
+    }
+
+    void removeFromPostings (Item& item)
+    {
+        for (const auto& word : item.words)
+        {
+            if (auto bucket = postings.find (VerbHashing::hash (word.text)); bucket != postings.end())
+            {
+                bucket->second.removeIf ([&] (const Posting& p) { return p.item == &item; });
+
+                if (bucket->second.isEmpty())
+                    postings.erase (bucket);
+            }
+        }
+    }
+
+    void readWords (Item& item)
+    {
+        item.words.clear();
+        item.numNameWords = 0;
+
+        ValueTree definition;
+
+        if (findDefinition != nullptr)
+            if (const auto* prototypeName = item.tree.getPropertyPointer (prototypeId))
+                definition = findDefinition (prototypeName->toString());
+
+        // In order of weight, so that scoreWord() meets the best field first:
+        addWords (item, readField (item.tree, definition, nameId), Field::name);
+        addWords (item, readField (item.tree, definition, interactionIdId), Field::interactionId);
+        addWords (item, readField (item.tree, definition, subtypeId), Field::subtype);
+    }
+
+    void reindex (Item& item)
+    {
+        removeFromPostings (item);
+        readWords (item);
+        addToPostings (item);
+    }
+
+    void updateOrder (int startIndex)
+    {
+        for (int i = jmax (0, startIndex); i < items.size(); ++i)
+            items.getUnchecked (i)->order = i;
+    }
+
+    void insertItem (int index, const ValueTree& child)
+    {
+        auto* item = items.insert (index, new Item (*this, child));
+        readWords (*item);
+        addToPostings (*item);
+        updateOrder (index);
+    }
+
+    void removeItem (int index)
+    {
+        if (auto* item = items[index])
+        {
+            removeFromPostings (*item);
+            items.remove (index);
+            updateOrder (index);
+        }
+    }
+
+    //==============================================================================
+    void valueTreeChildAdded (ValueTree& parent, ValueTree& child) override
+    {
+        if (parent != world)
+            return;
+
+        const auto last = world.getNumChildren() - 1;
+        insertItem (world.getChild (last) == child ? last : world.indexOf (child), child);
+    }
+
+    void valueTreeChildRemoved (ValueTree& parent, ValueTree&, int index) override
+    {
+        if (parent == world)
+            removeItem (index);
+    }
+
+    void valueTreeChildOrderChanged (ValueTree& parent, int oldIndex, int newIndex) override
+    {
+        if (parent == world)
+        {
+            items.move (oldIndex, newIndex);
+            updateOrder (jmin (oldIndex, newIndex));
+        }
+    }
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (NameIndex)
+};
@@ -0,0 +1,154 @@
+//==============================================================================
+/** Converts engine property values to and from the var stored in a ValueTree.
+
+    By default this defers to juce::VariantConverter, but geometric and colour
+    properties are specialised to be stored as packed integers rather than text,
+    so that reading them back never needs to parse a string.
+
+    @see CachedProperty, EngineObject
+*/
+template<typename Type>
+struct PropertyConverter final
+{
+    /** @returns */
+    static Type fromVar (const var& v)      { return juce::VariantConverter<Type>::fromVar (v); }
+    /** @returns */
+    static var toVar (const Type& value)    { return juce::VariantConverter<Type>::toVar (value); }
+};
+
+//==============================================================================
+/** Rectangles are packed into an int64 as four 16-bit fields:
+    a signed x and y, and an unsigned width and height.
+
+    Rectangles that don't fit are stored in the older text format (eg: "x y w h")
+    instead of being truncated, and saves holding it are still understood.
+*/
+template<>
+struct PropertyConverter<Rectangle<int>> final
+{
+    /** @returns */
+    static Rectangle<int> fromVar (const var& v)
+    {
+        if (v.isInt64() || v.isInt())
+            return unpack (static_cast<int64> (v));
+
+        if (v.isString())
+        {
+            // Packed values that went through XML come back as plain decimal text:
+            const auto text = v.toString();
+            if (text.isNotEmpty() && text.containsOnly ("-0123456789"))
+                return unpack (text.getLargeIntValue());
+
+            return juce::VariantConverter<Rectangle<int>>::fromVar (v);
+        }
+
+        return {};
+    }
+
+    /** @returns */
+    static var toVar (const Rectangle<int>& r)
+    {
+        if (! canPack (r))
+            return juce::VariantConverter<Rectangle<int>>::toVar (r);
+
+        const auto packed = (static_cast<uint64> (static_cast<uint16> (r.getX())) << 48)
+                          | (static_cast<uint64> (static_cast<uint16> (r.getY())) << 32)
+                          | (static_cast<uint64> (static_cast<uint16> (r.getWidth())) << 16)
+                          | static_cast<uint64> (static_cast<uint16> (r.getHeight()));
+
+        return static_cast<int64> (packed);
+    }
+
+private:
+    static bool canPack (const Rectangle<int>& r) noexcept
+    {
+        const auto isInt16 = [] (int v) { return v >= std::numeric_limits<int16>::min() && v <= std::numeric_limits<int16>::max(); };
+        const auto isUint16 = [] (int v) { return isPositiveAndNotGreaterThan (v, (int) std::numeric_limits<uint16>::max()); };
+
+        return isInt16 (r.getX()) && isInt16 (r.getY()) && isUint16 (r.getWidth()) && isUint16 (r.getHeight());
+    }
+
+    static Rectangle<int> unpack (int64 value) noexcept
+    {
+        const auto packed = static_cast<uint64> (value);
+
+        return { static_cast<int16> (packed >> 48),
+                 static_cast<int16> (packed >> 32),
+                 static_cast<uint16> (packed >> 16),
+                 static_cast<uint16> (packed) };
+    }
+};
+
+//==============================================================================
+/** Points are packed into an int64, with x in the upper 32 bits and y in the lower 32 bits. */
+template<>
+struct PropertyConverter<Point<int>> final
+{
+    /** @returns */
+    static Point<int> fromVar (const var& v)
+    {
+        if (v.isInt64() || v.isInt())
+            return unpack (static_cast<int64> (v));
+
+        if (v.isString())
+            return unpack (v.toString().getLargeIntValue());
+
+        return {};
+    }
+
+    /** @returns */
+    static var toVar (const Point<int>& p)
+    {
+        return static_cast<int64> ((static_cast<uint64> (static_cast<uint32> (p.x)) << 32)
+                                   | static_cast<uint64> (static_cast<uint32> (p.y)));
+    }
+
+private:
+    static Point<int> unpack (int64 value) noexcept
+    {
+        const auto packed = static_cast<uint64> (value);
+        return { static_cast<int> (static_cast<uint32> (packed >> 32)),
+                 static_cast<int> (static_cast<uint32> (packed)) };
+    }
+};
+
+//==============================================================================
+/** Colours are stored as their ARGB value in an int64, tagged with bit 32
+    so that the decimal text they become after going through XML can't be
+    mistaken for the older hexadecimal format, which is still understood.
+*/
+template<>
+struct PropertyConverter<Colour> final
+{
+    /** @returns */
+    static Colour fromVar (const var& v)
+    {
+        if (v.isInt64() || v.isInt())
+            return unpack (static_cast<int64> (v));
+
+        if (v.isString())
+        {
+            const auto text = v.toString();
+            if (text.length() > 8 && text.containsOnly ("0123456789"))
+                return unpack (text.getLargeIntValue());
+
+            return juce::VariantConverter<Colour>::fromVar (v);
+        }
+
+        return {};
+    }
+
+    /** @returns */
+    static var toVar (const Colour& c)
+    {
+        return static_cast<int64> (tag | static_cast<uint64> (c.getARGB()));
+    }
+
+private:
+    static constexpr uint64 tag = 1ull << 32;
+
+    static Colour unpack (int64 value) noexcept
+    {
+        return Colour (static_cast<uint32> (static_cast<uint64> (value) & 0xffffffff));
+    }
+};
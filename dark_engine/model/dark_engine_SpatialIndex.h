@@ -0,0 +1,446 @@
+//==============================================================================
+/** A uniform-grid spatial index over the direct children of a world ValueTree.
+
+    Each child is bucketed into every cell that its dimensions overlap,
+    so point, area and radius queries only visit the cells they touch
+    instead of walking and decoding every child of the world.
+    Queries are clipped to the cells that hold anything, and never visit
+    more cells than that, so a huge area or radius costs no more than the index's size.
+
+    A child that would cover more than maxCellsPerObject cells is kept
+    in a separate list of oversized objects instead, which every query checks.
+
+    The index keeps itself current by listening to the world for children
+    being added, removed or reordered, and to each child for changes to
+    its dimensions.
+
+    Children without dimensions, or with empty dimensions, are tracked
+    but never returned by a query.
+
+    A query's callback may make other queries, but mustn't change the world,
+    since that would change the buckets being gone through. Queries keep some
+    scratch state in the index, so it mustn't be queried from several threads at once.
+
+    @see GameMap, WorldObject
+*/
+class SpatialIndex final : private ValueTree::Listener
+{
+public:
+    /** */
+    SpatialIndex (const ValueTree& worldState, int cellSizeToUse = 16) :
+        world (worldState),
+        cellSize (jmax (1, cellSizeToUse))
+    {
+        items.ensureStorageAllocated (world.getNumChildren());
+
+        for (const auto& child : world)
+            insertItem (items.size(), child);
+
+        world.addListener (this);
+    }
+
+    /** */
+    ~SpatialIndex() override
+    {
+        world.removeListener (this);
+    }
+
+    //==============================================================================
+    /** The most cells that a single object is bucketed into before it's considered oversized. */
+    static constexpr int maxCellsPerObject = 64;
+
+    /** @returns the size, in world units, of each square cell of the grid. */
+    [[nodiscard]] int getCellSize() const noexcept  { return cellSize; }
+    /** @returns the number of world children being tracked. */
+    [[nodiscard]] int getNumObjects() const noexcept { return items.size(); }
+
+    //==============================================================================
+    /** Calls the callback with the state of each object whose dimensions contain the point.
+        The callback's signature is: void (const ValueTree&)
+    */
+    template<typename Callback>
+    void forEachObjectAt (Point<int> point, Callback&& callback) const
+    {
+        forEachCandidate (getCellRange (point.x, point.y, point.x, point.y), [&] (const Item& item)
+        {
+            if (item.bounds.contains (point))
+                callback (item.tree);
+        });
+    }
+
+    /** Calls the callback with the state of each object whose dimensions intersect the area.
+        The callback's signature is: void (const ValueTree&)
+    */
+    template<typename Callback>
+    void forEachObjectWithin (Rectangle<int> area, Callback&& callback) const
+    {
+        if (area.isEmpty())
+            return;
+
+        forEachCandidate (getCellRange (area), [&] (const Item& item)
+        {
+            if (item.bounds.intersects (area))
+                callback (item.tree);
+        });
+    }
+
+    /** Calls the callback with the state of each object whose dimensions
+        come within the radius of the centre point.
+        The callback's signature is: void (const ValueTree&)
+    */
+    template<typename Callback>
+    void forEachObjectWithinRadius (Point<int> centre, int radius, Callback&& callback) const
+    {
+        const auto r = static_cast<int64> (jmax (0, radius));
+        const auto radiusSquared = r * r;
+
+        forEachCandidate (getCellRange (centre.x - r, centre.y - r, centre.x + r, centre.y + r), [&] (const Item& item)
+        {
+            const auto& b = item.bounds;
+            const auto dx = static_cast<int64> (jlimit (b.getX(), b.getRight() - 1, centre.x) - centre.x);
+            const auto dy = static_cast<int64> (jlimit (b.getY(), b.getBottom() - 1, centre.y) - centre.y);
+
+            if (dx * dx + dy * dy <= radiusSquared)
+                callback (item.tree);
+        });
+    }
+
+    //==============================================================================
+    /** @returns the states of all objects whose dimensions contain the point. */
+    [[nodiscard]] Array<ValueTree> findObjectsAt (Point<int> point) const
+    {
+        Array<ValueTree> results;
+        forEachObjectAt (point, [&] (const ValueTree& v) { results.add (v); });
+        return results;
+    }
+
+    /** @returns the states of all objects whose dimensions intersect the area. */
+    [[nodiscard]] Array<ValueTree> findObjectsWithin (Rectangle<int> area) const
+    {
+        Array<ValueTree> results;
+        forEachObjectWithin (area, [&] (const ValueTree& v) { results.add (v); });
+        return results;
+    }
+
+    /** @returns the states of all objects whose dimensions come within the radius of the centre point. */
+    [[nodiscard]] Array<ValueTree> findObjectsWithinRadius (Point<int> centre, int radius) const
+    {
+        Array<ValueTree> results;
+        forEachObjectWithinRadius (centre, radius, [&] (const ValueTree& v) { results.add (v); });
+        return results;
+    }
+
+private:
+    //==============================================================================
+    /** Mirrors a single child of the world, listening to it directly
+        so that a change of dimensions can be reindexed without a search.
+    */
+    struct Item final : private ValueTree::Listener
+    {
+        Item (SpatialIndex& o, const ValueTree& t) :
+            owner (o),
+            tree (t)
+        {
+            tree.addListener (this);
+        }
+
+        ~Item() override
+        {
+            tree.removeListener (this);
+        }
+
+        void valueTreePropertyChanged (ValueTree& t, const Identifier& id) override
+        {
+            if (id == dimensionsId && t == tree)
+                owner.reindex (*this);
+        }
+
+        SpatialIndex& owner;
+        ValueTree tree;
+        Rectangle<int> bounds;
+        bool isOversized = false;
+        mutable uint32 lastVisit = 0;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Item)
+    };
+
+    //==============================================================================
+    ValueTree world;
+    const int cellSize;
+    OwnedArray<Item> items; // Kept in the same order as the world's children.
+    std::unordered_map<int64, Array<Item*>> cells;
+    Array<Item*> oversized;
+    mutable uint32 visitStamp = 0;
+    mutable int queryDepth = 0; // More than 1 while a query is made from within another's callback.
+
+    /** An inclusive range of cells. */
+    struct CellRange final
+    {
+        int x1 = 0, y1 = 0, x2 = -1, y2 = -1;
+
+        [[nodiscard]] bool isEmpty() const noexcept     { return x2 < x1 || y2 < y1; }
+        [[nodiscard]] bool contains (int x, int y) const noexcept { return x >= x1 && x <= x2 && y >= y1 && y <= y2; }
+
+        [[nodiscard]] int64 getNumCells() const noexcept
+        {
+            return isEmpty() ? 0 : (static_cast<int64> (x2) - x1 + 1) * (static_cast<int64> (y2) - y1 + 1);
+        }
+
+        [[nodiscard]] CellRange getIntersection (const CellRange& other) const noexcept
+        {
+            return { jmax (x1, other.x1), jmax (y1, other.y1), jmin (x2, other.x2), jmin (y2, other.y2) };
+        }
+
+        [[nodiscard]] CellRange getUnion (const CellRange& other) const noexcept
+        {
+            if (isEmpty())          return other;
+            if (other.isEmpty())    return *this;
+
+            return { jmin (x1, other.x1), jmin (y1, other.y1), jmax (x2, other.x2), jmax (y2, other.y2) };
+        }
+    };
+
+    // The cells that hold anything, or somewhat more after a removal, until the next query:
+    mutable CellRange occupied;
+    mutable bool isOccupiedStale = false;
+
+    //==============================================================================
+    [[nodiscard]] static int64 toKey (int cellX, int cellY) noexcept
+    {
+        return (static_cast<int64> (cellX) << 32) | static_cast<uint32> (cellY);
+    }
+
+    [[nodiscard]] static int getKeyX (int64 key) noexcept   { return static_cast<int> (key >> 32); }
+    [[nodiscard]] static int getKeyY (int64 key) noexcept   { return static_cast<int> (static_cast<uint32> (key)); }
+
+    [[nodiscard]] int toCell (int64 v) const noexcept
+    {
+        const auto cell = v >= 0 ? v / cellSize : -((-v - 1) / cellSize) - 1;
+        return static_cast<int> (jlimit<int64> (std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), cell));
+    }
+
+    /** @returns the cells covering the inclusive range of world positions, which may be past the range of an int. */
+    [[nodiscard]] CellRange getCellRange (int64 left, int64 top, int64 right, int64 bottom) const noexcept
+    {
+        return { toCell (left), toCell (top), toCell (right), toCell (bottom) };
+    }
+
+    [[nodiscard]] CellRange getCellRange (Rectangle<int> area) const noexcept
+    {
+        if (area.isEmpty())
+            return {};
+
+        return getCellRange (area.getX(), area.getY(),
+                             static_cast<int64> (area.getX()) + area.getWidth() - 1,
+                             static_cast<int64> (area.getY()) + area.getHeight() - 1);
+    }
+
+    [[nodiscard]] const CellRange& getOccupiedCells() const
+    {
+        if (isOccupiedStale)
+        {
+            occupied = {};
+
+            for (const auto& cell : cells)
+            {
+                const auto x = getKeyX (cell.first), y = getKeyY (cell.first);
+                occupied = occupied.getUnion ({ x, y, x, y });
+            }
+
+            isOccupiedStale = false;
+        }
+
+        return occupied;
+    }
+
+    [[nodiscard]] static Rectangle<int> readBounds (const ValueTree& tree)
+    {
+        if (const auto* v = tree.getPropertyPointer (dimensionsId))
+            return PropertyConverter<Rectangle<int>>::fromVar (*v);
+
+        return {};
+    }
+
+    template<typename Callback>
+    static void forEachCell (const CellRange& range, Callback&& callback)
+    {
+        // Counted in int64, so that a range reaching the last cell can't overflow:
+        for (int64 y = range.y1; y <= range.y2; ++y)
+            for (int64 x = range.x1; x <= range.x2; ++x)
+                callback (toKey ((int) x, (int) y));
+    }
+
+    /** Visits each oversized item, and each item bucketed in the cells of the range, once. */
+    template<typename Callback>
+    void forEachCandidate (const CellRange& range, Callback&& callback) const
+    {
+        if (range.isEmpty() || (cells.empty() && oversized.isEmpty()))
+            return;
+
+        const ScopedValueSetter<int> nesting (queryDepth, queryDepth + 1);
+
+        if (queryDepth > 1)
+        {
+            // The stamps are still in use by the query whose callback made this one,
+            // so this one remembers its own visits instead:
+            std::unordered_set<const Item*> visited;
+
+            forEachBucket (range, [&] (const Array<Item*>& bucket)
+            {
+                for (auto* item : bucket)
+                    if (visited.insert (item).second)
+                        callback (*item);
+            });
+
+            return;
+        }
+
+        if (++visitStamp == 0) // Wrapped around, so forget all previous visits.
+        {
+            for (auto* item : items)
+                item->lastVisit = 0;
+
+            visitStamp = 1;
+        }
+
+        forEachBucket (range, [&] (const Array<Item*>& bucket)
+        {
+            for (auto* item : bucket)
+            {
+                if (item->lastVisit != visitStamp)
+                {
+                    item->lastVisit = visitStamp;
+                    callback (*item);
+                }
+            }
+        });
+    }
+
+    /** Calls the callback with the oversized items, then with each bucket in the cells of the range. */
+    template<typename Callback>
+    void forEachBucket (const CellRange& range, Callback&& visit) const
+    {
+        visit (oversized);
+
+        const auto clipped = range.getIntersection (getOccupiedCells());
+
+        if (clipped.getNumCells() > static_cast<int64> (cells.size()))
+        {
+            // Fewer cells are occupied than the range covers, so it's cheaper to go through those:
+            for (const auto& cell : cells)
+                if (clipped.contains (getKeyX (cell.first), getKeyY (cell.first)))
+                    visit (cell.second);
+
+            return;
+        }
+
+        forEachCell (clipped, [&] (int64 key)
+        {
+            if (const auto cell = cells.find (key); cell != cells.end())
+                visit (cell->second);
+        });
+    }
+
+    //==============================================================================
+    void addToCells (Item& item)
+    {
+        // Don't change the world from within a query's callback!
+        jassert (queryDepth == 0);
+
+        const auto range = getCellRange (item.bounds);
+
+        if (range.isEmpty())
+            return;
+
+        if (range.getNumCells() > maxCellsPerObject)
+        {
+            item.isOversized = true;
+            oversized.add (&item);
+            return;
+        }
+
+        forEachCell (range, [&] (int64 key) { cells[key].add (&item); });
+
+        if (! isOccupiedStale)
+            occupied = occupied.getUnion (range);
+    }
+
+    void removeFromCells (Item& item)
+    {
+        // Don't change the world from within a query's callback!
+        jassert (queryDepth == 0);
+
+        if (item.isOversized)
+        {
+            item.isOversized = false;
+            oversized.removeFirstMatchingValue (&item);
+            return;
+        }
+
+        forEachCell (getCellRange (item.bounds), [&] (int64 key)
+        {
+            if (auto cell = cells.find (key); cell != cells.end())
+            {
+                cell->second.removeFirstMatchingValue (&item);
+
+                if (cell->second.isEmpty())
+                {
+                    cells.erase (cell);
+                    isOccupiedStale = true;
+                }
+            }
+        });
+    }
+
+    void reindex (Item& item)
+    {
+        const auto newBounds = readBounds (item.tree);
+        if (newBounds == item.bounds)
+            return;
+
+        removeFromCells (item);
+        item.bounds = newBounds;
+        addToCells (item);
+    }
+
+    void insertItem (int index, const ValueTree& child)
+    {
+        auto* item = items.insert (index, new Item (*this, child));
+        item->bounds = readBounds (child);
+        addToCells (*item);
+    }
+
+    void removeItem (int index)
+    {
+        if (auto* item = items[index])
+        {
+            removeFromCells (*item);
+            items.remove (index);
+        }
+    }
+
+    //==============================================================================
+    void valueTreeChildAdded (ValueTree& parent, ValueTree& child) override
+    {
+        if (parent != world)
+            return;
+
+        const auto last = world.getNumChildren() - 1;
+        insertItem (world.getChild (last) == child ? last : world.indexOf (child), child);
+    }
+
+    void valueTreeChildRemoved (ValueTree& parent, ValueTree&, int index) override
+    {
+        if (parent == world)
+            removeItem (index);
+    }
+
+    void valueTreeChildOrderChanged (ValueTree& parent, int oldIndex, int newIndex) override
+    {
+        if (parent == world)
+            items.move (oldIndex, newIndex);
+    }
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpatialIndex)
+};
@@ -0,0 +1,143 @@
+//==============================================================================
+/** Keeps track of which direct children of a world ValueTree are afflicted,
+    ie: have a StatusCondition that isn't normal, either of their own
+    or inherited from their prototype.
+
+    Like SpatialIndex, the index keeps itself current by listening to the world,
+    but with a single listener: a child is only looked at again when it's added,
+    or when its status condition or prototype changes, so an idle world costs nothing.
+    A change to the definitions makes the index rebuild itself once,
+    the next time it's asked for the afflicted objects.
+
+    The afflicted objects are kept in the order they became afflicted,
+    starting in world order, which only depends on the order of the changes made.
+
+    @see StatusEngine, GameMap
+*/
+class StatusIndex final : private ValueTree::Listener
+{
+public:
+    /** */
+    StatusIndex (const ValueTree& worldState, const ValueTree& definitionsState,
+                 Prototype::DefinitionFinder definitionFinder = nullptr) :
+        world (worldState),
+        definitions (definitionsState),
+        findDefinition (std::move (definitionFinder))
+    {
+        rebuild();
+
+        world.addListener (this);
+        definitions.addListener (this);
+    }
+
+    /** */
+    ~StatusIndex() override
+    {
+        world.removeListener (this);
+        definitions.removeListener (this);
+    }
+
+    //==============================================================================
+    /** @returns the states of the afflicted objects. */
+    [[nodiscard]] const Array<ValueTree>& getAfflictedObjects() const
+    {
+        if (needsRebuild)
+            rebuild();
+
+        return afflicted;
+    }
+
+    /** @returns the status condition flags of a child of the world, falling back to its prototype's. */
+    [[nodiscard]] int getStatusFlags (const ValueTree& child) const
+    {
+        if (const auto* v = child.getPropertyPointer (statusConditionId))
+            return static_cast<int> (*v);
+
+        const auto* name = child.getPropertyPointer (prototypeId);
+        if (name == nullptr || findDefinition == nullptr)
+            return 0;
+
+        const auto definitionName = name->toString();
+
+        if (! definitionFlags.contains (definitionName))
+            definitionFlags.set (definitionName, static_cast<int> (findDefinition (definitionName)[statusConditionId]));
+
+        return definitionFlags[definitionName];
+    }
+
+private:
+    //==============================================================================
+    ValueTree world, definitions;
+    const Prototype::DefinitionFinder findDefinition;
+
+    mutable Array<ValueTree> afflicted;
+    mutable HashMap<String, int> definitionFlags;
+    mutable bool needsRebuild = false;
+
+    //==============================================================================
+    void rebuild() const
+    {
+        afflicted.clearQuick();
+        definitionFlags.clear();
+        needsRebuild = false;
+
+        for (const auto& child : world)
+            if (getStatusFlags (child) != 0)
+                afflicted.add (child);
+    }
+
+    void reindex (const ValueTree& child)
+    {
+        if (needsRebuild)
+            return;
+
+        const auto isAfflicted = getStatusFlags (child) != 0;
+        const auto index = afflicted.indexOf (child);
+
+        if (isAfflicted && index < 0)
+            afflicted.add (child);
+        else if (! isAfflicted && index >= 0)
+            afflicted.remove (index);
+    }
+
+    [[nodiscard]] bool isDefinitionChange (const ValueTree& tree) const
+    {
+        return tree == definitions || tree.isAChildOf (definitions);
+    }
+
+    //==============================================================================
+    void valueTreePropertyChanged (ValueTree& tree, const Identifier& id) override
+    {
+        if (id != statusConditionId && id != prototypeId && id != nameId && id != definitionKeyId)
+            return;
+
+        if (tree.getParent() == world)
+        {
+            if (id == statusConditionId || id == prototypeId)
+                reindex (tree);
+        }
+        else if (isDefinitionChange (tree))
+        {
+            needsRebuild = true;
+        }
+    }
+
+    void valueTreeChildAdded (ValueTree& parent, ValueTree& child) override
+    {
+        if (parent == world)
+            reindex (child);
+        else if (isDefinitionChange (parent))
+            needsRebuild = true;
+    }
+
+    void valueTreeChildRemoved (ValueTree& parent, ValueTree& child, int) override
+    {
+        if (parent == world)
+            afflicted.removeFirstMatchingValue (child);
+        else if (isDefinitionChange (parent))
+            needsRebuild = true;
+    }
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StatusIndex)
+};
@@ -0,0 +1,525 @@
+//==============================================================================
+/** A dense, chunked store for the plain tiles of a map.
+
+    Plain floors, walls, windows, stairs and the likes are kept as 8 byte
+    PackedTile entries inside square chunks of chunkSize x chunkSize tiles,
+    which are only allocated where a map actually has tiles.
+
+    Tiles that carry unique state (eg: a DoorTile with Unlockable IDs,
+    or a tile holding an inventory) can be promoted to full EngineTile
+    objects. The grid owns those and keeps their packed entry in sync,
+    so a caller walking the grid sees every tile the same way.
+    Moving a promoted tile moves its entry along with it.
+
+    The grid can mirror its chunks into a state, with a tileChunk child per chunk
+    holding its packed tiles as binary data, so that the tiles are saved along
+    with the state. The mirror is written in place as tiles change, without
+    notifying any listeners, since tile edits aren't undoable anyway.
+
+    @see GameMap, EngineTile, DoorTile
+*/
+class TileGrid final
+{
+public:
+    /** Creates an empty grid that isn't mirrored into any state. */
+    TileGrid() = default;
+
+    /** Creates a grid that mirrors its chunks into the state,
+        starting with whatever chunks the state already holds.
+
+        Promoted tiles aren't part of the mirror, since their states live elsewhere
+        (eg: in a GameMap's world), so they have to be promoted again after loading.
+    */
+    explicit TileGrid (const ValueTree& stateToMirror) :
+        mirror (stateToMirror)
+    {
+        for (int i = mirror.getNumChildren(); --i >= 0;)
+            if (! restoreChunk (mirror.getChild (i)))
+                mirror.removeChild (i, nullptr);
+    }
+
+    //==============================================================================
+    /** The number of tiles along each side of a chunk. */
+    static constexpr int chunkSize = 32;
+
+    /** */
+    enum Flags
+    {
+        /** Set when a tile exists at this position. */
+        occupied    = 1 << 0,
+        /** Set when the tile has been promoted to a full EngineTile. */
+        promoted    = 1 << 1,
+        /** Set when the tile blocks sight: walls, closed doors and secret doors. */
+        opaque      = 1 << 2
+    };
+
+    /** The packed representation of a single tile. */
+    struct PackedTile final
+    {
+        /** @returns */
+        [[nodiscard]] constexpr bool isOccupied() const noexcept        { return (flags & occupied) != 0; }
+        /** @returns */
+        [[nodiscard]] constexpr bool isPromoted() const noexcept        { return (flags & promoted) != 0; }
+        /** @returns */
+        [[nodiscard]] constexpr bool isOpaque() const noexcept          { return (flags & opaque) != 0; }
+        /** @returns */
+        [[nodiscard]] constexpr EngineTile::Type getType() const noexcept { return static_cast<EngineTile::Type> (type); }
+        /** @returns */
+        [[nodiscard]] constexpr Material getMaterial() const noexcept   { return static_cast<Material> (material); }
+        /** @returns */
+        [[nodiscard]] Colour getColour() const noexcept                 { return Colour (argb); }
+
+        uint32 argb = 0;
+        uint8 type = 0, material = 0, flags = 0, reserved = 0;
+    };
+
+    static_assert (sizeof (PackedTile) == 8);
+
+    //==============================================================================
+    /** Places a plain tile, replacing whatever was at the position.
+        Any promoted tile at that position is destroyed.
+    */
+    void setTile (Point<int> position,
+                  EngineTile::Type type,
+                  Material material = Material::stone,
+                  Colour colour = Colours::transparentBlack)
+    {
+        promotedTiles.erase (toKey (position));
+
+        auto& tile = getOrCreateTile (position);
+        tile.type = static_cast<uint8> (type);
+        tile.material = static_cast<uint8> (material);
+        tile.argb = colour.getARGB();
+        tile.flags = static_cast<uint8> (occupied | (blocksSight (type, {}) ? opaque : 0));
+        storeTile (position);
+        ++opacityRevision;
+    }
+
+    /** Removes the tile at the position, if any. */
+    void clearTile (Point<int> position)
+    {
+        promotedTiles.erase (toKey (position));
+        releaseTile (position);
+    }
+
+    /** @returns the packed tile at the position, which will be unoccupied if there is none. */
+    [[nodiscard]] PackedTile getTile (Point<int> position) const noexcept
+    {
+        if (const auto chunk = chunks.find (toKey (toChunk (position))); chunk != chunks.end())
+            return chunk->second->getTile (position);
+
+        return {};
+    }
+
+    /** @returns true if there's a tile at the position. */
+    [[nodiscard]] bool hasTile (Point<int> position) const noexcept { return getTile (position).isOccupied(); }
+
+    //==============================================================================
+    /** Takes ownership of a tile with unique state and places it at the position,
+        replacing whatever was there.
+
+        @returns the promoted tile.
+    */
+    EngineTile& promote (Point<int> position, std::unique_ptr<EngineTile> tile)
+    {
+        jassert (tile != nullptr);
+
+        tile->setPosition (position);
+
+        auto& packed = getOrCreateTile (position);
+        packed.flags = occupied | promoted;
+
+        auto& entry = promotedTiles[toKey (position)];
+        entry = std::make_unique<PromotedTile> (*this, position, std::move (tile));
+        ++opacityRevision;
+        return *entry->tile;
+    }
+
+    /** @returns the promoted tile at the position, or nullptr if there isn't one. */
+    [[nodiscard]] EngineTile* getPromotedTile (Point<int> position) const noexcept
+    {
+        if (const auto entry = promotedTiles.find (toKey (position)); entry != promotedTiles.end())
+            return entry->second->tile.get();
+
+        return nullptr;
+    }
+
+    /** Calls the callback with each promoted tile.
+        The callback's signature is: void (EngineTile&)
+    */
+    template<typename Callback>
+    void forEachPromotedTile (Callback&& callback) const
+    {
+        for (const auto& [key, entry] : promotedTiles)
+            callback (*entry->tile);
+    }
+
+    //==============================================================================
+    /** Calls the callback with each occupied tile within the area, row by row.
+        The callback's signature is: void (Point<int>, const PackedTile&)
+    */
+    template<typename Callback>
+    void forEachTileWithin (Rectangle<int> area, Callback&& callback) const
+    {
+        if (area.isEmpty())
+            return;
+
+        const auto first = toChunk (area.getPosition());
+        const auto last = toChunk (area.getBottomRight() - Point<int> (1, 1));
+
+        for (int cy = first.y; cy <= last.y; ++cy)
+        {
+            for (int cx = first.x; cx <= last.x; ++cx)
+            {
+                const auto chunk = chunks.find (toKey ({ cx, cy }));
+                if (chunk == chunks.end())
+                    continue;
+
+                const auto chunkArea = area.getIntersection ({ cx * chunkSize, cy * chunkSize, chunkSize, chunkSize });
+
+                for (int y = chunkArea.getY(); y < chunkArea.getBottom(); ++y)
+                {
+                    for (int x = chunkArea.getX(); x < chunkArea.getRight(); ++x)
+                    {
+                        const auto& tile = chunk->second->getTile ({ x, y });
+
+                        if (tile.isOccupied())
+                            callback (Point<int> (x, y), tile);
+                    }
+                }
+            }
+        }
+    }
+
+    //==============================================================================
+    /** One bit per tile of a chunk, with an element per row, and bit x of a row for the tile in column x. */
+    using ChunkBits = std::array<uint32, chunkSize>;
+
+    static_assert (sizeof (uint32) * 8 == chunkSize);
+
+    /** @returns the position of the chunk holding the tile at the position. */
+    [[nodiscard]] static Point<int> toChunk (Point<int> p) noexcept
+    {
+        constexpr auto shift = 5;
+        static_assert ((1 << shift) == chunkSize);
+        return { p.x >> shift, p.y >> shift };
+    }
+
+    /** @returns a bit set for each opaque tile of the chunk at the chunk position. */
+    [[nodiscard]] ChunkBits getOpaqueBits (Point<int> chunkPosition) const noexcept
+    {
+        ChunkBits bits {};
+
+        if (const auto chunk = chunks.find (toKey (chunkPosition)); chunk != chunks.end())
+            for (int i = 0; i < chunkSize * chunkSize; ++i)
+                if (chunk->second->tiles[(size_t) i].isOpaque())
+                    bits[(size_t) (i / chunkSize)] |= 1u << (i % chunkSize);
+
+        return bits;
+    }
+
+    /** @returns a number that changes whenever a tile is placed, removed,
+        or starts or stops blocking sight, for anything caching what can be seen.
+        @see FieldOfView
+    */
+    [[nodiscard]] uint32 getOpacityRevision() const noexcept { return opacityRevision; }
+
+    /** @returns true if a tile of the type blocks sight.
+        The state is only needed for the tiles that can open up, like a DoorTile:
+        a door is considered closed when it has no state, when it's locked in any way, or when it's secret.
+        A WindowTile can always be seen through, be it open or not.
+    */
+    [[nodiscard]] static bool blocksSight (EngineTile::Type type, const ValueTree& state)
+    {
+        switch (type)
+        {
+            case EngineTile::Type::wall:
+                return true;
+
+            case EngineTile::Type::door:
+                return ! state.isValid()
+                    || static_cast<bool> (state[secretId])
+                    || VariantConverter<DoorLockState>::fromVar (state[lockStateId]) != DoorLockState::unlocked;
+
+            default:
+                return false;
+        }
+    }
+
+    //==============================================================================
+    /** @returns the smallest area containing every tile. */
+    [[nodiscard]] Rectangle<int> getBounds() const
+    {
+        Rectangle<int> bounds;
+
+        for (const auto& [key, chunk] : chunks)
+        {
+            const auto origin = Point<int> (static_cast<int> (key >> 32), static_cast<int> (key & 0xffffffff)) * chunkSize;
+
+            for (int i = 0; i < chunkSize * chunkSize; ++i)
+            {
+                if (chunk->tiles[(size_t) i].isOccupied())
+                {
+                    const auto tileBounds = Rectangle<int> (origin.x + (i % chunkSize), origin.y + (i / chunkSize), 1, 1);
+                    bounds = bounds.isEmpty() ? tileBounds : bounds.getUnion (tileBounds);
+                }
+            }
+        }
+
+        return bounds;
+    }
+
+    //==============================================================================
+    /** @returns the number of tiles, promoted or not. */
+    [[nodiscard]] int getNumTiles() const noexcept          { return numTiles; }
+    /** @returns the number of promoted tiles. */
+    [[nodiscard]] int getNumPromotedTiles() const noexcept  { return (int) promotedTiles.size(); }
+    /** @returns the number of allocated chunks. */
+    [[nodiscard]] int getNumChunks() const noexcept         { return (int) chunks.size(); }
+
+    /** @returns the number of bytes held by the chunks, their mirror, and the promoted tiles. */
+    [[nodiscard]] size_t getMemoryUsage() const noexcept
+    {
+        const auto mirrorSize = mirror.isValid() ? sizeof (Chunk::tiles) : 0;
+
+        return chunks.size() * (sizeof (Chunk) + mirrorSize)
+             + promotedTiles.size() * (sizeof (PromotedTile) + sizeof (EngineTile));
+    }
+
+private:
+    //==============================================================================
+    struct Chunk final
+    {
+        PackedTile& getTile (Point<int> p) noexcept             { return tiles[toIndex (p)]; }
+        const PackedTile& getTile (Point<int> p) const noexcept { return tiles[toIndex (p)]; }
+
+        static size_t toIndex (Point<int> p) noexcept
+        {
+            return (size_t) ((p.y & (chunkSize - 1)) * chunkSize + (p.x & (chunkSize - 1)));
+        }
+
+        std::array<PackedTile, chunkSize * chunkSize> tiles {};
+        int numTiles = 0;
+        ValueTree state; // The chunk's mirror, if the grid has one.
+    };
+
+    /** Owns a promoted tile and mirrors its type, material, colour and opacity into the packed tile. */
+    struct PromotedTile final : private ValueTree::Listener
+    {
+        PromotedTile (TileGrid& o, Point<int> p, std::unique_ptr<EngineTile> t) :
+            owner (o),
+            position (p),
+            tile (std::move (t)),
+            state (tile->getState())
+        {
+            sync();
+            state.addListener (this);
+        }
+
+        ~PromotedTile() override
+        {
+            state.removeListener (this);
+        }
+
+        void sync()
+        {
+            auto& packed = owner.getOrCreateTile (position);
+            packed.type = static_cast<uint8> (tile->getType());
+            packed.material = static_cast<uint8> (tile->getMaterial());
+            packed.argb = tile->getColour().getARGB();
+
+            const auto wasOpaque = packed.isOpaque();
+            const auto isOpaque = blocksSight (tile->getType(), state);
+
+            if (isOpaque != wasOpaque)
+            {
+                packed.flags = static_cast<uint8> (isOpaque ? (packed.flags | opaque) : (packed.flags & ~opaque));
+                ++owner.opacityRevision;
+            }
+
+            owner.storeTile (position);
+        }
+
+        void valueTreePropertyChanged (ValueTree& t, const Identifier& id) override
+        {
+            if (t != state)
+                return;
+
+            if (id == dimensionsId)
+                owner.movePromotedTile (*this);
+            else if (id == typeId || id == materialId || id == colourId
+                     || id == lockStateId || id == secretId)
+                sync();
+        }
+
+        TileGrid& owner;
+        Point<int> position;
+        std::unique_ptr<EngineTile> tile;
+        ValueTree state;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PromotedTile)
+    };
+
+    //==============================================================================
+    ValueTree mirror;
+    std::unordered_map<int64, std::unique_ptr<Chunk>> chunks;
+    std::unordered_map<int64, std::unique_ptr<PromotedTile>> promotedTiles;
+    int numTiles = 0;
+    uint32 opacityRevision = 0;
+
+    //==============================================================================
+    [[nodiscard]] static int64 toKey (Point<int> p) noexcept
+    {
+        return (static_cast<int64> (p.x) << 32) | static_cast<uint32> (p.y);
+    }
+
+    PackedTile& getOrCreateTile (Point<int> position)
+    {
+        const auto chunkPosition = toChunk (position);
+        auto& chunk = chunks[toKey (chunkPosition)];
+
+        if (chunk == nullptr)
+        {
+            chunk = std::make_unique<Chunk>();
+
+            if (mirror.isValid())
+            {
+                chunk->state = ValueTree (tileChunkId);
+                chunk->state.setProperty (dimensionsId, PropertyConverter<Rectangle<int>>::toVar (getChunkArea (chunkPosition)), nullptr);
+                chunk->state.setProperty (tileId, var (chunk->tiles.data(), sizeof (chunk->tiles)), nullptr);
+                mirror.appendChild (chunk->state, nullptr);
+            }
+        }
+
+        auto& tile = chunk->getTile (position);
+
+        if (! tile.isOccupied())
+        {
+            tile.flags = occupied;
+            ++chunk->numTiles;
+            ++numTiles;
+        }
+
+        return tile;
+    }
+
+    /** Empties the packed tile at the position, freeing its chunk once that's empty. */
+    void releaseTile (Point<int> position)
+    {
+        const auto chunk = chunks.find (toKey (toChunk (position)));
+        if (chunk == chunks.end())
+            return;
+
+        auto& tile = chunk->second->getTile (position);
+
+        if (tile.isOccupied())
+        {
+            tile = {};
+            ++opacityRevision;
+            --numTiles;
+
+            if (--chunk->second->numTiles <= 0)
+            {
+                mirror.removeChild (chunk->second->state, nullptr);
+                chunks.erase (chunk);
+            }
+            else
+            {
+                storeTile (position);
+            }
+        }
+    }
+
+    /** Copies the packed tile at the position into its chunk's mirror, if there is one. */
+    void storeTile (Point<int> position)
+    {
+        const auto chunk = chunks.find (toKey (toChunk (position)));
+        if (chunk == chunks.end() || ! chunk->second->state.isValid())
+            return;
+
+        auto& c = *chunk->second;
+        const auto index = Chunk::toIndex (position);
+
+        if (auto* block = c.state[tileId].getBinaryData(); block != nullptr && block->getSize() == sizeof (c.tiles))
+            block->copyFrom (&c.tiles[index], index * sizeof (PackedTile), sizeof (PackedTile));
+        else
+            c.state.setProperty (tileId, var (c.tiles.data(), sizeof (c.tiles)), nullptr);
+    }
+
+    /** Rebuilds a chunk from its mirror, dropping the promoted flags since those tiles get promoted again.
+        @returns false if the state isn't a valid chunk.
+    */
+    bool restoreChunk (ValueTree chunkState)
+    {
+        const auto* block = chunkState[tileId].getBinaryData();
+
+        if (! chunkState.hasType (tileChunkId) || block == nullptr || block->getSize() != sizeof (Chunk::tiles))
+            return false;
+
+        const auto chunkPosition = toChunk (PropertyConverter<Rectangle<int>>::fromVar (chunkState[dimensionsId]).getPosition());
+        auto& chunk = chunks[toKey (chunkPosition)];
+
+        if (chunk != nullptr)
+            return false;
+
+        chunk = std::make_unique<Chunk>();
+        chunk->state = chunkState;
+        block->copyTo (chunk->tiles.data(), 0, sizeof (chunk->tiles));
+
+        for (auto& tile : chunk->tiles)
+        {
+            tile.flags &= static_cast<uint8> (~promoted);
+
+            if (tile.isOccupied())
+                ++chunk->numTiles;
+        }
+
+        numTiles += chunk->numTiles;
+        ++opacityRevision;
+
+        if (chunk->numTiles > 0)
+            return true;
+
+        chunks.erase (toKey (chunkPosition));
+        return false;
+    }
+
+    [[nodiscard]] static Rectangle<int> getChunkArea (Point<int> chunkPosition) noexcept
+    {
+        return { chunkPosition.x * chunkSize, chunkPosition.y * chunkSize, chunkSize, chunkSize };
+    }
+
+    /** Re-keys a promoted tile whose position changed, replacing any plain tile where it lands.
+        A move onto another promoted tile is undone, since its owner decides what happens to that one.
+    */
+    void movePromotedTile (PromotedTile& entry)
+    {
+        const auto newPosition = entry.tile->getPosition();
+        if (newPosition == entry.position)
+            return;
+
+        if (promotedTiles.find (toKey (newPosition)) != promotedTiles.end())
+        {
+            jassertfalse;
+            entry.tile->setPosition (entry.position);
+            return;
+        }
+
+        auto node = promotedTiles.extract (toKey (entry.position));
+        jassert (! node.empty() && node.mapped().get() == &entry);
+
+        releaseTile (entry.position);
+        entry.position = newPosition;
+
+        auto& packed = getOrCreateTile (newPosition);
+        packed.flags = occupied | promoted;
+        entry.sync();
+        ++opacityRevision;
+
+        node.key() = toKey (newPosition);
+        promotedTiles.insert (std::move (node));
+    }
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TileGrid)
+};
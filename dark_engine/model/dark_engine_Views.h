@@ -0,0 +1,319 @@
+//==============================================================================
+/** A lightweight, read-only view over the state of an EngineObject.
+
+    Views read properties straight from a ValueTree: they hold no caches,
+    register no listeners and never write to the tree, so they're cheap to
+    create in read-heavy loops like computing bounds, rendering and AI.
+
+    A property missing from the state falls back to the prototype's,
+    if one was provided, and then to the same default that the
+    equivalent mutating class would have written.
+
+    The mutating classes (EngineObject, WorldObject, etc) remain the API
+    for changing state.
+
+    @see EngineObject, Prototype
+*/
+class EngineObjectView
+{
+public:
+    /** */
+    explicit EngineObjectView (const ValueTree& stateToView, const ValueTree& prototypeToUse = {}) noexcept :
+        EngineObjectView (stateToView, prototypeToUse, getDefaults())
+    {
+    }
+
+    //==============================================================================
+    /** @returns true if the viewed state is valid. */
+    [[nodiscard]] bool isValid() const noexcept                 { return state.isValid(); }
+    /** @returns the viewed state. */
+    [[nodiscard]] const ValueTree& getState() const noexcept    { return state; }
+    /** @returns the prototype's definition, which will be invalid if there isn't one. */
+    [[nodiscard]] const ValueTree& getPrototype() const noexcept { return prototype; }
+    /** @returns */
+    [[nodiscard]] Identifier getType() const noexcept           { return state.getType(); }
+
+    /** @returns */
+    [[nodiscard]] String getName() const                        { return get<String> (nameId); }
+    /** @returns */
+    [[nodiscard]] String getDescription() const                 { return get<String> (descriptionId); }
+
+protected:
+    //==============================================================================
+    /** */
+    EngineObjectView (const ValueTree& stateToView, const ValueTree& prototypeToUse, const ValueTree& defaultsToUse) noexcept :
+        state (stateToView),
+        prototype (prototypeToUse),
+        defaults (defaultsToUse)
+    {
+    }
+
+    /** @returns the property from the state, the prototype, or the defaults, in that order. */
+    template<typename Type>
+    [[nodiscard]] Type get (const Identifier& id) const
+    {
+        if (const auto* v = state.getPropertyPointer (id))      return PropertyConverter<Type>::fromVar (*v);
+        if (const auto* v = prototype.getPropertyPointer (id))  return PropertyConverter<Type>::fromVar (*v);
+        if (const auto* v = defaults.getPropertyPointer (id))   return PropertyConverter<Type>::fromVar (*v);
+
+        return {};
+    }
+
+private:
+    //==============================================================================
+    ValueTree state, prototype;
+    const ValueTree& defaults;
+
+    static const ValueTree& getDefaults()
+    {
+        static const auto d = EngineObject (Identifier ("defaults")).getState();
+        return d;
+    }
+};
+
+//==============================================================================
+/** A read-only view over the state of a WorldObject.
+
+    @see WorldObject, EngineObjectView
+*/
+class WorldObjectView : public EngineObjectView
+{
+public:
+    /** */
+    explicit WorldObjectView (const ValueTree& stateToView, const ValueTree& prototypeToUse = {}) noexcept :
+        EngineObjectView (stateToView, prototypeToUse, getDefaults())
+    {
+    }
+
+    //==============================================================================
+    /** @returns */
+    [[nodiscard]] Rectangle<int> getDimensions() const  { return get<Rectangle<int>> (dimensionsId); }
+    /** @returns */
+    [[nodiscard]] Point<int> getPosition() const        { return getDimensions().getPosition(); }
+    /** @returns */
+    [[nodiscard]] int getWidth() const                  { return getDimensions().getWidth(); }
+    /** @returns */
+    [[nodiscard]] int getHeight() const                 { return getDimensions().getHeight(); }
+
+    //==============================================================================
+    /** @returns */
+    [[nodiscard]] String getInteractionId() const       { return get<String> (interactionIdId); }
+    /** @returns */
+    [[nodiscard]] bool isInteractable() const           { return getInteractionId().isNotEmpty(); }
+
+    //==============================================================================
+    /** @returns */
+    [[nodiscard]] Colour getLightColour() const         { return get<Colour> (lightColourId); }
+    /** @returns */
+    [[nodiscard]] bool castsLight() const               { return ! getLightColour().isTransparent(); }
+    /** @returns */
+    [[nodiscard]] int getLightRadius() const            { return get<int> (lightRadiusId); }
+
+    //==============================================================================
+    /** @returns */
+    [[nodiscard]] String getMapIcon() const             { return get<String> (mapIconId); }
+    /** @returns */
+    [[nodiscard]] String getScreenIcon() const          { return get<String> (screenIconId); }
+    /** @returns */
+    [[nodiscard]] String getInventoryIcon() const       { return get<String> (inventoryIconId); }
+
+protected:
+    //==============================================================================
+    /** */
+    using EngineObjectView::EngineObjectView;
+
+private:
+    //==============================================================================
+    static const ValueTree& getDefaults()
+    {
+        static const auto d = WorldObject (Identifier ("defaults")).getState();
+        return d;
+    }
+};
+
+//==============================================================================
+/** A read-only view over the state of a WorldEntity.
+
+    @see WorldEntity, WorldObjectView
+*/
+class WorldEntityView : public WorldObjectView
+{
+public:
+    /** */
+    explicit WorldEntityView (const ValueTree& stateToView, const ValueTree& prototypeToUse = {}) noexcept :
+        WorldObjectView (stateToView, prototypeToUse, getDefaults())
+    {
+    }
+
+    //==============================================================================
+    /** @returns */
+    [[nodiscard]] String getSubtype() const             { return get<String> (subtypeId); }
+    /** @returns */
+    [[nodiscard]] double getDirectionDegrees() const    { return get<double> (directionId); }
+    /** @returns */
+    [[nodiscard]] bool isNPC() const                    { return get<bool> (isNPCId); }
+    /** @returns */
+    [[nodiscard]] Difficulty getDifficulty() const      { return get<Difficulty> (difficultyId); }
+    /** @returns a weight in kilograms. */
+    [[nodiscard]] double getWeight() const              { return get<double> (weightId); }
+
+    /** @returns */
+    [[nodiscard]] int getNumInventoryItems() const      { return getState().getChildWithName (inventoryId).getNumChildren(); }
+
+protected:
+    //==============================================================================
+    /** */
+    using WorldObjectView::WorldObjectView;
+
+private:
+    //==============================================================================
+    static const ValueTree& getDefaults()
+    {
+        static const auto d = WorldEntity (Identifier ("defaults"), false).getState();
+        return d;
+    }
+};
+
+//==============================================================================
+/** A read-only view over the state of a FightableEntity.
+
+    @see FightableEntity, WorldEntityView
+*/
+class FightableEntityView final : public WorldEntityView
+{
+public:
+    /** */
+    explicit FightableEntityView (const ValueTree& stateToView, const ValueTree& prototypeToUse = {}) noexcept :
+        WorldEntityView (stateToView, prototypeToUse, getDefaults())
+    {
+    }
+
+    //==============================================================================
+    /** @returns */
+    [[nodiscard]] MoveType getWeakAgainstType() const           { return get<MoveType> (weakAgainstTypeId); }
+    /** @returns */
+    [[nodiscard]] StatusCondition getStatusCondition() const    { return get<StatusCondition> (statusConditionId); }
+    /** @returns */
+    [[nodiscard]] Nature getNature() const                      { return get<Nature> (natureId); }
+
+    //==============================================================================
+    /** @returns */
+    [[nodiscard]] int getLevel() const                          { return get<int> (levelId); }
+    /** @returns */
+    [[nodiscard]] int getExperience() const                     { return get<int> (experienceId); }
+    /** @returns */
+    [[nodiscard]] int getHitPoints() const                      { return get<int> (hitPointsId); }
+    /** @returns */
+    [[nodiscard]] int getMaxHitPoints() const                   { return get<int> (maxHitPointsId); }
+    /** @returns */
+    [[nodiscard]] int getAttack() const                         { return get<int> (attackId); }
+    /** @returns */
+    [[nodiscard]] int getDefense() const                        { return get<int> (defenseId); }
+    /** @returns */
+    [[nodiscard]] int getSpecialAttack() const                  { return get<int> (specialAttackId); }
+    /** @returns */
+    [[nodiscard]] int getSpecialDefense() const                 { return get<int> (specialDefenseId); }
+    /** @returns */
+    [[nodiscard]] int getSpeed() const                          { return get<int> (speedId); }
+
+    /** @returns */
+    [[nodiscard]] bool isAlive() const                          { return getHitPoints() > 0; }
+    /** @returns */
+    [[nodiscard]] bool isDead() const                           { return getHitPoints() <= 0; }
+
+    //==============================================================================
+    /** @returns */
+    [[nodiscard]] int getNumFightingMoves() const               { return getFightingMoves().getNumChildren(); }
+    /** @returns the state of a fighting move, to be read with a FightingMoveView. */
+    [[nodiscard]] ValueTree getFightingMoveState (int index) const
+    {
+        return getFightingMoves().getChild (index);
+    }
+
+    /** @returns the state's fighting moves, or the prototype's if the state has none of its own. */
+    [[nodiscard]] ValueTree getFightingMoves() const
+    {
+        if (auto own = getState().getChildWithName (fightingMovesId); own.getNumChildren() > 0)
+            return own;
+
+        return getPrototype().getChildWithName (fightingMovesId);
+    }
+
+private:
+    //==============================================================================
+    static const ValueTree& getDefaults()
+    {
+        static const auto d = FightableEntity (Identifier ("defaults"), false).getState();
+        return d;
+    }
+};
+
+//==============================================================================
+/** A read-only view over the state of a FightingMove.
+
+    @see FightingMove, EngineObjectView
+*/
+class FightingMoveView final : public EngineObjectView
+{
+public:
+    /** */
+    explicit FightingMoveView (const ValueTree& stateToView, const ValueTree& prototypeToUse = {}) noexcept :
+        EngineObjectView (stateToView, prototypeToUse, getDefaults())
+    {
+    }
+
+    //==============================================================================
+    /** @returns */
+    [[nodiscard]] MoveType getMoveType() const          { return get<MoveType> (moveTypeId); }
+    /** @returns */
+    [[nodiscard]] MoveCategory getMoveCategory() const  { return get<MoveCategory> (moveCategoryId); }
+    /** @returns */
+    [[nodiscard]] int getPriority() const               { return get<int> (priorityId); }
+    /** @returns */
+    [[nodiscard]] int getPower() const                  { return get<int> (powerId); }
+    /** @returns */
+    [[nodiscard]] int getAccuracy() const               { return get<int> (accuracyId); }
+    /** @returns */
+    [[nodiscard]] int getPowerPoints() const            { return get<int> (powerPointsId); }
+    /** @returns */
+    [[nodiscard]] int getMaxPowerPoints() const         { return get<int> (maxPowerPointsId); }
+
+private:
+    //==============================================================================
+    static const ValueTree& getDefaults()
+    {
+        static const auto d = FightingMove (Identifier ("defaults")).getState();
+        return d;
+    }
+};
+
+//==============================================================================
+/** A read-only view over the state of an EngineTile.
+
+    @see EngineTile, WorldObjectView
+*/
+class EngineTileView final : public WorldObjectView
+{
+public:
+    /** */
+    explicit EngineTileView (const ValueTree& stateToView) noexcept :
+        WorldObjectView (stateToView, {}, getDefaults())
+    {
+    }
+
+    //==============================================================================
+    /** @returns */
+    [[nodiscard]] EngineTile::Type getTileType() const  { return static_cast<EngineTile::Type> (get<int> (typeId)); }
+    /** @returns */
+    [[nodiscard]] Material getMaterial() const          { return static_cast<Material> (get<int> (materialId)); }
+    /** @returns */
+    [[nodiscard]] Colour getColour() const              { return get<Colour> (colourId); }
+
+private:
+    //==============================================================================
+    static const ValueTree& getDefaults()
+    {
+        static const auto d = EngineTile().getState();
+        return d;
+    }
+};
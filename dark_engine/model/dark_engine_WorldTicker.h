@@ -0,0 +1,410 @@
+//==============================================================================
+/** Calls WorldObject::update() on a set of live objects, but only when there's
+    a reason to: because their state changed, or because a timer they asked for is due.
+
+    Each registered object is listened to directly, so any change to its state,
+    or to anything below it (eg: its inventory), marks it as dirty. Timed events,
+    like a door that should close by itself, are scheduled on a timing wheel
+    of numSlots slots, where each tick only looks at the one slot that's due.
+
+    Every tick, the objects that went dirty since the last one and the objects
+    whose timers are due are updated once each, in the order they were marked.
+    A tick in which nothing happened touches no object at all, no matter how
+    many are registered.
+
+    Changes that an object makes to its own state from within update() don't
+    mark it dirty again. Changes it makes to other objects do, but those are
+    only updated on the next tick.
+
+    The objects aren't owned: remove them before they're destroyed.
+    An object can find the ticker it's registered with through WorldObject::getTicker(),
+    like to schedule its own timers from within update().
+
+    @see GameMap, WorldObject, LiveObjects
+*/
+class WorldTicker final
+{
+public:
+    /** */
+    WorldTicker() = default;
+
+    /** */
+    ~WorldTicker()
+    {
+        for (auto& item : items)
+            if (item != nullptr)
+                item->object.ticker = nullptr;
+    }
+
+    //==============================================================================
+    /** The number of slots in the timing wheel.
+        Timers further away than this are kept in their slot until their turn comes around.
+    */
+    static constexpr int numSlots = 256;
+
+    //==============================================================================
+    /** Starts tracking the object, which will be updated on the next tick.
+        An object can only be tracked by one ticker at a time.
+    */
+    void add (WorldObject& object)
+    {
+        if (contains (object))
+            return;
+
+        jassert (object.ticker == nullptr);
+        object.ticker = this;
+
+        int index = 0;
+
+        if (freeIndices.empty())
+        {
+            index = (int) items.size();
+            items.emplace_back();
+        }
+        else
+        {
+            index = freeIndices.back();
+            freeIndices.pop_back();
+        }
+
+        items[(size_t) index] = std::make_unique<Item> (*this, object, index, ++lastSerial);
+        indices[&object] = index;
+        markDirty (*items[(size_t) index]);
+    }
+
+    /** Stops tracking the object, dropping any of its timers. */
+    void remove (WorldObject& object)
+    {
+        const auto entry = indices.find (&object);
+        if (entry == indices.end())
+            return;
+
+        const auto index = entry->second;
+        indices.erase (entry);
+
+        if (items[(size_t) index]->isDirty)
+            --numDirty;
+
+        object.ticker = nullptr;
+
+        items[(size_t) index].reset();
+        freeIndices.push_back (index);
+    }
+
+    /** @returns true if the object is being tracked. */
+    [[nodiscard]] bool contains (const WorldObject& object) const   { return indices.contains (&object); }
+
+    //==============================================================================
+    /** Makes sure that the object is updated on the next tick,
+        like after changing something that it depends on but doesn't own.
+    */
+    void markDirty (WorldObject& object)
+    {
+        if (auto* item = findItem (object))
+            markDirty (*item);
+    }
+
+    /** Updates the object once the number of ticks have gone by,
+        whether or not anything about it changed by then.
+
+        Scheduling doesn't replace the object's other timers, so the object's
+        update() should check its state rather than assume why it was called.
+    */
+    void schedule (WorldObject& object, int numTicksFromNow)
+    {
+        auto* item = findItem (object);
+        if (item == nullptr)
+        {
+            jassertfalse; // Add the object first!
+            return;
+        }
+
+        const auto due = currentTick + (uint64) jmax (1, numTicksFromNow);
+        slots[(size_t) (due % (uint64) numSlots)].push_back ({ item->index, item->serial, due });
+        ++numTimers;
+    }
+
+    //==============================================================================
+    /** Moves forward by one tick, updating every object that's dirty or has a timer due.
+
+        @returns the number of objects that were updated.
+    */
+    int tick()
+    {
+        ++currentTick;
+        lastNumUpdated = 0;
+
+        auto& slot = slots[(size_t) (currentTick % (uint64) numSlots)];
+
+        if (dirty.empty() && slot.empty())
+            return 0;
+
+        // Both are swapped out first, so that anything marked or scheduled
+        // by an update lands in the lists for a later tick:
+        std::swap (dirty, dirtyScratch);
+        std::swap (slot, slotScratch);
+
+        for (const auto& ref : dirtyScratch)
+        {
+            if (auto* item = resolve (ref); item != nullptr && item->isDirty)
+            {
+                item->isDirty = false;
+                --numDirty;
+                update (*item);
+            }
+        }
+
+        for (const auto& timer : slotScratch)
+        {
+            if (timer.due > currentTick)
+            {
+                slot.push_back (timer);
+                continue;
+            }
+
+            --numTimers;
+
+            if (auto* item = resolve (timer))
+                update (*item);
+        }
+
+        dirtyScratch.clear();
+        slotScratch.clear();
+        return lastNumUpdated;
+    }
+
+    //==============================================================================
+    /** @returns the number of ticks gone through. */
+    [[nodiscard]] uint64 getTick() const noexcept               { return currentTick; }
+    /** @returns the number of objects being tracked. */
+    [[nodiscard]] int getNumObjects() const noexcept            { return (int) indices.size(); }
+    /** @returns the number of objects that will be updated on the next tick because they changed. */
+    [[nodiscard]] int getNumDirty() const noexcept              { return numDirty; }
+    /** @returns the number of timers that haven't gone off yet, including those of removed objects. */
+    [[nodiscard]] int getNumTimers() const noexcept             { return numTimers; }
+    /** @returns the number of objects that the last tick updated. */
+    [[nodiscard]] int getLastNumUpdated() const noexcept        { return lastNumUpdated; }
+
+private:
+    //==============================================================================
+    /** Tracks a single object, listening to its state so that any change marks it as dirty. */
+    struct Item final : private ValueTree::Listener
+    {
+        Item (WorldTicker& o, WorldObject& wo, int i, uint32 s) :
+            owner (o),
+            object (wo),
+            tree (wo.getState()),
+            index (i),
+            serial (s)
+        {
+            tree.addListener (this);
+        }
+
+        ~Item() override
+        {
+            tree.removeListener (this);
+        }
+
+        void changed()
+        {
+            if (owner.updating != this)
+                owner.markDirty (*this);
+        }
+
+        void valueTreePropertyChanged (ValueTree&, const Identifier&) override  { changed(); }
+        void valueTreeChildAdded (ValueTree&, ValueTree&) override              { changed(); }
+        void valueTreeChildRemoved (ValueTree&, ValueTree&, int) override       { changed(); }
+        void valueTreeChildOrderChanged (ValueTree&, int, int) override         { changed(); }
+
+        WorldTicker& owner;
+        WorldObject& object;
+        ValueTree tree;
+        const int index;
+        const uint32 serial;
+        bool isDirty = false;
+        uint64 lastUpdatedTick = 0;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Item)
+    };
+
+    /** Refers to an item by its index, as long as it's still the same item. */
+    struct Ref final
+    {
+        int index = 0;
+        uint32 serial = 0;
+        uint64 due = 0;
+    };
+
+    //==============================================================================
+    std::vector<std::unique_ptr<Item>> items;
+    std::vector<int> freeIndices;
+    std::unordered_map<const WorldObject*, int> indices;
+
+    std::vector<Ref> dirty, dirtyScratch, slotScratch;
+    std::array<std::vector<Ref>, numSlots> slots;
+
+    uint64 currentTick = 0;
+    uint32 lastSerial = 0;
+    int numDirty = 0, numTimers = 0, lastNumUpdated = 0;
+    Item* updating = nullptr;
+
+    //==============================================================================
+    [[nodiscard]] Item* findItem (const WorldObject& object) const
+    {
+        if (const auto entry = indices.find (&object); entry != indices.end())
+            return items[(size_t) entry->second].get();
+
+        return nullptr;
+    }
+
+    [[nodiscard]] Item* resolve (const Ref& ref) const noexcept
+    {
+        if (auto* item = items[(size_t) ref.index].get(); item != nullptr && item->serial == ref.serial)
+            return item;
+
+        return nullptr;
+    }
+
+    void markDirty (Item& item)
+    {
+        if (item.isDirty)
+            return;
+
+        item.isDirty = true;
+        ++numDirty;
+        dirty.push_back ({ item.index, item.serial, currentTick });
+    }
+
+    /** Updates the item at most once per tick. The item may be removed by its own update. */
+    void update (Item& item)
+    {
+        if (item.lastUpdatedTick == currentTick)
+            return;
+
+        item.lastUpdatedTick = currentTick;
+        ++lastNumUpdated;
+
+        updating = &item;
+        item.object.update();
+        updating = nullptr;
+    }
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WorldTicker)
+};
+
+//==============================================================================
+/** Keeps a live WorldObject for each child of a world that was made from a definition,
+    like the objects that GameMap::spawn() adds, and registers each with a WorldTicker,
+    so that they get updated when they change or their timers are due.
+
+    The world is listened to, so objects are picked up however they got there:
+    spawned, brought back by an undo, or saved along with the map.
+    The player and the tiles aren't included: the GameMap registers those itself.
+
+    @see GameMap, WorldTicker
+*/
+class LiveObjects final : private ValueTree::Listener
+{
+public:
+    /** Finds the prototype that a world child was made from. */
+    using PrototypeFinder = std::function<Prototype (const ValueTree& state)>;
+
+    /** */
+    LiveObjects (const ValueTree& worldState, WorldTicker& tickerToUse, PrototypeFinder prototypeFinder) :
+        world (worldState),
+        ticker (tickerToUse),
+        findPrototype (std::move (prototypeFinder))
+    {
+        jassert (findPrototype != nullptr);
+
+        objects.ensureStorageAllocated (world.getNumChildren());
+
+        for (const auto& child : world)
+            insertObject (objects.size(), child);
+
+        world.addListener (this);
+    }
+
+    /** */
+    ~LiveObjects() override
+    {
+        world.removeListener (this);
+
+        for (auto* object : objects)
+            if (object != nullptr)
+                ticker.remove (*object);
+    }
+
+    //==============================================================================
+    /** @returns the number of live objects. */
+    [[nodiscard]] int getNumObjects() const noexcept { return numObjects; }
+
+    /** @returns the live object wrapping the world child at the index, if it has one. */
+    [[nodiscard]] WorldObject* getObject (int childIndex) const noexcept { return objects[childIndex]; }
+
+    /** @returns true if the world child gets a live object. */
+    [[nodiscard]] static bool isLive (const ValueTree& child)
+    {
+        return child.hasProperty (prototypeId) && ! child.hasType (playerId) && ! child.hasType (tileId);
+    }
+
+private:
+    //==============================================================================
+    ValueTree world;
+    WorldTicker& ticker;
+    const PrototypeFinder findPrototype;
+    OwnedArray<WorldObject> objects; // One per world child, or nullptr for those that aren't live.
+    int numObjects = 0;
+
+    //==============================================================================
+    void insertObject (int index, const ValueTree& child)
+    {
+        WorldObject* object = nullptr;
+
+        if (isLive (child))
+        {
+            object = new WorldObject (child, findPrototype (child));
+            ticker.add (*object);
+            ++numObjects;
+        }
+
+        objects.insert (index, object);
+    }
+
+    void removeObject (int index)
+    {
+        if (auto* object = objects[index])
+        {
+            ticker.remove (*object);
+            --numObjects;
+        }
+
+        objects.remove (index);
+    }
+
+    //==============================================================================
+    void valueTreeChildAdded (ValueTree& parent, ValueTree& child) override
+    {
+        if (parent != world)
+            return;
+
+        const auto last = world.getNumChildren() - 1;
+        insertObject (world.getChild (last) == child ? last : world.indexOf (child), child);
+    }
+
+    void valueTreeChildRemoved (ValueTree& parent, ValueTree&, int index) override
+    {
+        if (parent == world)
+            removeObject (index);
+    }
+
+    void valueTreeChildOrderChanged (ValueTree& parent, int oldIndex, int newIndex) override
+    {
+        if (parent == world)
+            objects.move (oldIndex, newIndex);
+    }
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LiveObjects)
+};
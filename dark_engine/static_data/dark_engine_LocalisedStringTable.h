@@ -0,0 +1,191 @@
+//==============================================================================
+/** A fixed list of strings, translated once per language and then handed out
+    by reference, for the names of the engine's enums, flags and IDs.
+
+    Each language's strings are built the first time that language is used,
+    then kept for as long as the table lives, so switching back and forth
+    between languages only ever translates each of them once. Lookups read
+    the current language's strings through an atomic pointer, so they neither
+    lock, allocate nor translate anything, and can happen on any thread.
+
+    A lookup notices when the current LocalisedStrings have been replaced,
+    and switches the table over to their language then and there, which is
+    the only time that a lookup locks or translates. Calling refreshAll(),
+    which a LanguageRefresher does on every change of language, switches
+    every table over up front instead.
+
+    @see toString, getEquivalentName
+*/
+class LocalisedStringTable final
+{
+public:
+    /** Makes the string at an index, in the current language. */
+    using Builder = std::function<String (int index)>;
+
+    /** Creates a table of the translations of the untranslated strings. */
+    LocalisedStringTable (std::initializer_list<const char*> untranslatedStrings) :
+        LocalisedStringTable ((int) untranslatedStrings.size(),
+                              [untranslated = std::vector<const char*> (untranslatedStrings)] (int index)
+                              {
+                                  return TRANS (untranslated[(size_t) index]);
+                              })
+    {
+    }
+
+    /** Creates a table of strings made by the builder, like the combinations of a set of flags.
+        The builder is called again for each new language.
+
+        The builder should translate with TRANS rather than read other tables,
+        since the other tables might not have been refreshed yet.
+    */
+    LocalisedStringTable (int numStringsToUse, Builder builderToUse) :
+        numStrings (jmax (0, numStringsToUse)),
+        builder (std::move (builderToUse))
+    {
+        jassert (builder != nullptr);
+
+        refresh();
+
+        auto& registry = getRegistry();
+        const ScopedLock sl (registry.lock);
+        registry.tables.add (this);
+    }
+
+    /** */
+    ~LocalisedStringTable()
+    {
+        auto& registry = getRegistry();
+        const ScopedLock sl (registry.lock);
+        registry.tables.removeFirstMatchingValue (this);
+    }
+
+    //==============================================================================
+    /** @returns the number of strings. */
+    [[nodiscard]] int size() const noexcept { return numStrings; }
+
+    /** @returns the string at the index in the current language,
+        or an empty string if the index is out of range.
+    */
+    [[nodiscard]] const String& operator[] (int index) const
+    {
+        if (isPositiveAndBelow (index, numStrings))
+        {
+            if (mappings.load (std::memory_order_acquire) != LocalisedStrings::getCurrentMappings())
+                refresh();
+
+            return current.load (std::memory_order_acquire)->strings.getReference (index);
+        }
+
+        jassertfalse;
+        return emptyString;
+    }
+
+    //==============================================================================
+    /** Switches this table over to the language of the current LocalisedStrings. */
+    void refresh() const
+    {
+        const ScopedLock sl (lock);
+
+        const auto* newMappings = LocalisedStrings::getCurrentMappings();
+        const auto language = getCurrentLanguage();
+
+        auto* table = [&]() -> Language*
+        {
+            for (auto* existing : languages)
+                if (existing->language == language)
+                    return existing;
+
+            return nullptr;
+        }();
+
+        if (table == nullptr)
+        {
+            table = languages.add (new Language());
+            table->language = language;
+            table->strings.ensureStorageAllocated (numStrings);
+
+            for (int i = 0; i < numStrings; ++i)
+                table->strings.add (builder (i));
+        }
+
+        if (current.exchange (table, std::memory_order_acq_rel) != table)
+            ++getRegistry().generation;
+
+        mappings.store (newMappings, std::memory_order_release);
+    }
+
+    /** Switches every table over to the language of the current LocalisedStrings. */
+    static void refreshAll()
+    {
+        auto& registry = getRegistry();
+
+        {
+            const ScopedLock sl (registry.lock);
+
+            for (auto* table : registry.tables)
+                table->refresh();
+        }
+
+        ++registry.generation;
+    }
+
+    /** @returns a number that changes every time the tables are refreshed,
+        so that a UI can tell when it needs to redisplay its text.
+    */
+    [[nodiscard]] static uint32 getGeneration() noexcept { return getRegistry().generation.load(); }
+
+    //==============================================================================
+    /** Refreshes every table whenever a LanguageHandler changes language,
+        for apps that have one, so that no lookup has to do it later.
+    */
+    struct LanguageRefresher final : public LanguageHandler::Listener
+    {
+        /** @internal */
+        void languageChanged (const IETFLanguageFile&) override { refreshAll(); }
+    };
+
+private:
+    //==============================================================================
+    struct Language final
+    {
+        String language;
+        Array<String> strings;
+    };
+
+    struct Registry final
+    {
+        CriticalSection lock;
+        Array<LocalisedStringTable*> tables;
+        std::atomic<uint32> generation { 0 };
+    };
+
+    const int numStrings;
+    const Builder builder;
+
+    // These only change when switching languages, which lookups can do.
+    CriticalSection lock;
+    mutable OwnedArray<Language> languages; // Never removed from, so the current one can be read without locking.
+    mutable std::atomic<Language*> current { nullptr };
+    mutable std::atomic<const LocalisedStrings*> mappings { nullptr };
+
+    static inline const String emptyString;
+
+    //==============================================================================
+    [[nodiscard]] static Registry& getRegistry()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    [[nodiscard]] static String getCurrentLanguage()
+    {
+        if (auto* mappings = LocalisedStrings::getCurrentMappings())
+            return mappings->getLanguageName() + "/" + mappings->getCountryCodes().joinIntoString (",");
+
+        return {};
+    }
+
+    //==============================================================================
+    // No leak detector, since tables are mostly function statics that outlive it.
+    JUCE_DECLARE_NON_COPYABLE (LocalisedStringTable)
+};
@@ -0,0 +1,165 @@
+//==============================================================================
+/** The case-folding hash and the compile-time builder behind VerbTable. */
+struct VerbHashing final
+{
+    /** */
+    static constexpr uint32 tableSize = 2048;
+    /** */
+    static constexpr uint32 mask = tableSize - 1;
+    /** */
+    static constexpr uint16 emptySlot = 0xffff;
+
+    /** */
+    struct Table final
+    {
+        std::array<uint16, tableSize> slots {};
+        int maxProbeLength = 0;
+        size_t maxVerbLength = 0;
+    };
+
+    //==============================================================================
+    /** @returns */
+    [[nodiscard]] static constexpr char toLower (char c) noexcept
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char> (c + ('a' - 'A')) : c;
+    }
+
+    /** @returns a 32-bit FNV-1a hash of the case-folded characters. */
+    [[nodiscard]] static constexpr uint32 hash (std::string_view text) noexcept
+    {
+        uint32 h = 2166136261u;
+
+        for (const auto c : text)
+        {
+            h ^= static_cast<uint8> (toLower (c));
+            h *= 16777619u;
+        }
+
+        return h;
+    }
+
+    /** @returns true if the lower-case verb matches the token, ignoring the token's case. */
+    [[nodiscard]] static constexpr bool equalsIgnoringCase (std::string_view verb, std::string_view token) noexcept
+    {
+        if (verb.size() != token.size())
+            return false;
+
+        for (size_t i = 0; i < verb.size(); ++i)
+            if (verb[i] != toLower (token[i]))
+                return false;
+
+        return true;
+    }
+
+    /** @returns a table of indices into verbs[], placed by linear probing. */
+    [[nodiscard]] static constexpr Table build() noexcept
+    {
+        Table t;
+
+        for (auto& slot : t.slots)
+            slot = emptySlot;
+
+        for (int i = 0; i < static_cast<int> (std::size (verbs)); ++i)
+        {
+            const auto verb = std::string_view (verbs[i]);
+            auto slot = hash (verb) & mask;
+            int probe = 0;
+
+            while (t.slots[slot] != emptySlot)
+            {
+                slot = (slot + 1) & mask;
+                ++probe;
+            }
+
+            t.slots[slot] = static_cast<uint16> (i);
+            t.maxProbeLength = jmax (t.maxProbeLength, probe);
+            t.maxVerbLength = jmax (t.maxVerbLength, verb.size());
+        }
+
+        return t;
+    }
+
+private:
+    //==============================================================================
+    VerbHashing() = delete;
+};
+
+//==============================================================================
+/** A hash table over verbs[], built at compile time, for recognising the verbs
+    the player types in constant time and without allocating.
+
+    Lookups are case-insensitive, folding the token's case as it's hashed and
+    compared rather than making a lower-cased copy of it.
+
+    The table is open-addressed with linear probing at a load factor below
+    one half, and the longest probe sequence any verb needs is computed along
+    with the table and checked against a small bound, so every lookup touches
+    at most a handful of slots.
+
+    @see verbs
+*/
+class VerbTable final
+{
+public:
+    /** The number of verbs in the table. */
+    static constexpr int numVerbs = static_cast<int> (std::size (verbs));
+
+    /** Returned by find() when a token isn't a verb. */
+    static constexpr int notFound = -1;
+
+    //==============================================================================
+    /** @returns the index of the verb within verbs[], or notFound. */
+    [[nodiscard]] static constexpr int find (std::string_view token) noexcept
+    {
+        if (token.empty() || token.size() > table.maxVerbLength)
+            return notFound;
+
+        auto slot = VerbHashing::hash (token) & VerbHashing::mask;
+
+        for (int probe = 0; probe <= table.maxProbeLength; ++probe, slot = (slot + 1) & VerbHashing::mask)
+        {
+            const auto index = table.slots[slot];
+
+            if (index == VerbHashing::emptySlot)
+                return notFound;
+
+            if (VerbHashing::equalsIgnoringCase (verbs[index], token))
+                return static_cast<int> (index);
+        }
+
+        return notFound;
+    }
+
+    /** @returns the index of the verb within verbs[], or notFound. */
+    [[nodiscard]] static int find (const String& token) noexcept
+    {
+        return find (std::string_view (token.toRawUTF8(), token.getNumBytesAsUTF8()));
+    }
+
+    /** @returns true if the token is a verb. */
+    [[nodiscard]] static constexpr bool isVerb (std::string_view token) noexcept  { return find (token) != notFound; }
+
+    /** @returns the verb at the index, which must be valid. */
+    [[nodiscard]] static const char* getVerb (int index) noexcept
+    {
+        jassert (isPositiveAndBelow (index, numVerbs));
+        return verbs[index];
+    }
+
+    /** @returns the most slots any verb's lookup has to probe past its home slot. */
+    [[nodiscard]] static constexpr int getMaxProbeLength() noexcept { return table.maxProbeLength; }
+
+private:
+    //==============================================================================
+    static_assert (isPowerOfTwo (VerbHashing::tableSize));
+    static_assert (numVerbs * 2 < static_cast<int> (VerbHashing::tableSize));
+    static_assert (numVerbs < VerbHashing::emptySlot);
+
+    static constexpr VerbHashing::Table table = VerbHashing::build();
+
+    // If this fails after adding verbs, change the hash or grow the table:
+    static_assert (table.maxProbeLength <= 16);
+
+    //==============================================================================
+    VerbTable() = delete;
+};
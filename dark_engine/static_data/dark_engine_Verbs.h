@@ -1,4 +1,4 @@
-static const char* const verbs[] =
+static constexpr const char* verbs[] =
 {
     NEEDS_TRANS ("accept"),       // NEEDS_TRANS (""),
     NEEDS_TRANS ("ache"),         // NEEDS_TRANS (""),
@@ -553,7 +553,6 @@ static const char* const verbs[] =
     NEEDS_TRANS ("mumble"),       // NEEDS_TRANS (""),
     NEEDS_TRANS ("murder"),       // NEEDS_TRANS (""),
     NEEDS_TRANS ("mutter"),       // NEEDS_TRANS (""),
-    NEEDS_TRANS ("N"),            // NEEDS_TRANS (""),
     NEEDS_TRANS ("nag"),          // NEEDS_TRANS (""),
     NEEDS_TRANS ("nail"),         // NEEDS_TRANS (""),
     NEEDS_TRANS ("name"),         // NEEDS_TRANS (""),
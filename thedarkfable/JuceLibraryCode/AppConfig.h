@@ -52,6 +52,13 @@
 
 #define JUCE_GLOBAL_MODULE_SETTINGS_INCLUDED 1
 
+//==============================================================================
+// dark_engine flags:
+
+#ifndef    DARK_ENGINE_ENABLE_COMPONENTS
+ //#define DARK_ENGINE_ENABLE_COMPONENTS 1
+#endif
+
 //==============================================================================
 // juce_audio_devices flags:
 
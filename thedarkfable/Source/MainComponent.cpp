@@ -2,20 +2,17 @@
 
 MainComponent::MainComponent()
 {
-    worldState.addListener (this);
-    editor.setSize (1024, 1024);
-    viewport.setViewedComponent (&editor, false);
-
-    worldStateEditor.addPropertyParser (std::make_unique<DifficultyPropertyParser>());
-    worldStateEditor.addPropertyParser (std::make_unique<DoorLockStatePropertyParser>());
-    worldStateEditor.addPropertyParser (std::make_unique<MaterialPropertyParser>());
-    worldStateEditor.addPropertyParser (std::make_unique<MoveTypePropertyParser>());
-    worldStateEditor.addPropertyParser (std::make_unique<StatusConditionPropertyParser>());
+    tabbedComp.addTab (TRANS ("Game Map"), Colours::black, &viewport, false);
 
-    worldStateEditor.translateIdToString = darkEngine::getEquivalentName;
+    showCurrentMap();
 
-    tabbedComp.addTab (TRANS ("Game Map"), Colours::black, &viewport, false);
-    tabbedComp.addTab (TRANS ("World State"), Colours::black, &worldStateEditor, false);
+    // Synchronously, because the previous map may be evicted as soon as this returns:
+    gameProcessor.worldManager.onMapEntered = [this] (GameMap&)
+    {
+        JUCE_ASSERT_MESSAGE_THREAD
+        showCurrentMap();
+        triggerAsyncUpdate();
+    };
 
     addAndMakeVisible (tabbedComp);
     setSize (800, 800);
@@ -25,10 +22,44 @@ MainComponent::MainComponent()
 
 MainComponent::~MainComponent()
 {
+    gameProcessor.worldManager.onMapEntered = nullptr;
     worldState.removeListener (this);
     undoManager.clearUndoHistory(); // Do this explicitly because of the destruction order.
 }
 
+//==============================================================================
+void MainComponent::showCurrentMap()
+{
+    auto& gameMap = gameProcessor.getCurrentMap();
+
+    worldState.removeListener (this);
+    worldState = gameMap.getWorldState();
+    worldState.addListener (this);
+
+    viewport.setViewedComponent (nullptr, false);
+    editor = std::make_unique<GameMapEditorComponent> (gameMap);
+    editor->setSize (1024, 1024);
+    viewport.setViewedComponent (editor.get(), false);
+
+    const auto currentTab = tabbedComp.getCurrentTabIndex();
+
+    if (worldStateEditor != nullptr)
+        tabbedComp.removeTab (1);
+
+    worldStateEditor = std::make_unique<ValueTreeEditor> (worldState);
+    worldStateEditor->addPropertyParser (std::make_unique<ColourPropertyParser>());
+    worldStateEditor->addPropertyParser (std::make_unique<DifficultyPropertyParser>());
+    worldStateEditor->addPropertyParser (std::make_unique<DimensionsPropertyParser>());
+    worldStateEditor->addPropertyParser (std::make_unique<DoorLockStatePropertyParser>());
+    worldStateEditor->addPropertyParser (std::make_unique<MaterialPropertyParser>());
+    worldStateEditor->addPropertyParser (std::make_unique<MoveTypePropertyParser>());
+    worldStateEditor->addPropertyParser (std::make_unique<StatusConditionPropertyParser>());
+    worldStateEditor->translateIdToString = darkEngine::getEquivalentName;
+
+    tabbedComp.addTab (TRANS ("World State"), Colours::black, worldStateEditor.get(), false);
+    tabbedComp.setCurrentTabIndex (jmax (0, currentTab));
+}
+
 //==============================================================================
 Rectangle<int> MainComponent::calculateMapBounds() const
 {
@@ -36,11 +67,14 @@ Rectangle<int> MainComponent::calculateMapBounds() const
 
     for (const auto& c : worldState)
     {
-        const auto rect = WorldObject (c).getDimensions();
+        const auto rect = WorldObjectView (c).getDimensions();
         if (! rect.isEmpty() || rect.isFinite())
             list.addWithoutMerging (rect);
     }
 
+    if (const auto tileBounds = gameProcessor.getCurrentMap().getTileGrid().getBounds(); ! tileBounds.isEmpty())
+        list.addWithoutMerging (tileBounds);
+
     return list.getBounds();
 }
 
@@ -57,7 +91,7 @@ void MainComponent::resized()
 
 void MainComponent::handleAsyncUpdate()
 {
-    editor.setBounds (calculateMapBounds());
+    editor->setBounds (calculateMapBounds());
 }
 
 void MainComponent::valueTreeChildAdded (ValueTree&, ValueTree&)
@@ -138,16 +138,17 @@ private:
     //==============================================================================
     UndoManager undoManager;
     GameProcessor gameProcessor;
-    GameMap& gameMap = gameProcessor.gameMap;
-    ValueTree worldState = gameMap.getWorldState();
-    GameMapEditorComponent editor { gameMap };
-    Viewport viewport;
 
-    ValueTreeEditor worldStateEditor { worldState };
+    // These follow the current map, which changes whenever the player goes through a MapLink:
+    ValueTree worldState;
+    std::unique_ptr<GameMapEditorComponent> editor;
+    std::unique_ptr<ValueTreeEditor> worldStateEditor;
 
+    Viewport viewport;
     TabbedComponent tabbedComp { TabbedButtonBar::TabsAtTop };
 
     //==============================================================================
+    void showCurrentMap();
     Rectangle<int> calculateMapBounds() const;
 
     //==============================================================================
@@ -0,0 +1,154 @@
+/*
+
+    IMPORTANT! This file is auto-generated each time you save your
+    project - if you alter its contents, your changes may be overwritten!
+
+    There's a section below where you can add your own custom code safely, and the
+    Projucer will preserve the contents of that block, but the best way to change
+    any of these definitions is by using the Projucer's project settings.
+
+    Any commented-out settings will assume their default values.
+
+*/
+
+#pragma once
+
+//==============================================================================
+// [BEGIN_USER_CODE_SECTION]
+
+// (You can add your own code in this section, and the Projucer will not overwrite it)
+
+// [END_USER_CODE_SECTION]
+
+#define JUCE_PROJUCER_VERSION 0x80008
+
+//==============================================================================
+#define JUCE_MODULE_AVAILABLE_dark_engine               1
+#define JUCE_MODULE_AVAILABLE_juce_core                 1
+#define JUCE_MODULE_AVAILABLE_juce_cryptography         1
+#define JUCE_MODULE_AVAILABLE_juce_data_structures      1
+#define JUCE_MODULE_AVAILABLE_juce_events               1
+#define JUCE_MODULE_AVAILABLE_juce_graphics             1
+#define JUCE_MODULE_AVAILABLE_squarepine_core           1
+
+#define JUCE_GLOBAL_MODULE_SETTINGS_INCLUDED 1
+
+//==============================================================================
+// dark_engine flags:
+
+#ifndef    DARK_ENGINE_ENABLE_COMPONENTS
+ #define   DARK_ENGINE_ENABLE_COMPONENTS 0
+#endif
+
+//==============================================================================
+// juce_core flags:
+
+#ifndef    JUCE_FORCE_DEBUG
+ //#define JUCE_FORCE_DEBUG 0
+#endif
+
+#ifndef    JUCE_LOG_ASSERTIONS
+ //#define JUCE_LOG_ASSERTIONS 0
+#endif
+
+#ifndef    JUCE_CHECK_MEMORY_LEAKS
+ //#define JUCE_CHECK_MEMORY_LEAKS 1
+#endif
+
+#ifndef    JUCE_DONT_AUTOLINK_TO_WIN32_LIBRARIES
+ //#define JUCE_DONT_AUTOLINK_TO_WIN32_LIBRARIES 0
+#endif
+
+#ifndef    JUCE_INCLUDE_ZLIB_CODE
+ //#define JUCE_INCLUDE_ZLIB_CODE 1
+#endif
+
+#ifndef    JUCE_USE_CURL
+ //#define JUCE_USE_CURL 1
+#endif
+
+#ifndef    JUCE_LOAD_CURL_SYMBOLS_LAZILY
+ //#define JUCE_LOAD_CURL_SYMBOLS_LAZILY 0
+#endif
+
+#ifndef    JUCE_CATCH_UNHANDLED_EXCEPTIONS
+ //#define JUCE_CATCH_UNHANDLED_EXCEPTIONS 0
+#endif
+
+#ifndef    JUCE_ALLOW_STATIC_NULL_VARIABLES
+ //#define JUCE_ALLOW_STATIC_NULL_VARIABLES 0
+#endif
+
+#ifndef    JUCE_STRICT_REFCOUNTEDPOINTER
+ #define   JUCE_STRICT_REFCOUNTEDPOINTER 1
+#endif
+
+#ifndef    JUCE_ENABLE_ALLOCATION_HOOKS
+ //#define JUCE_ENABLE_ALLOCATION_HOOKS 0
+#endif
+
+//==============================================================================
+// juce_events flags:
+
+#ifndef    JUCE_EXECUTE_APP_SUSPEND_ON_BACKGROUND_TASK
+ //#define JUCE_EXECUTE_APP_SUSPEND_ON_BACKGROUND_TASK 0
+#endif
+
+//==============================================================================
+// juce_graphics flags:
+
+#ifndef    JUCE_USE_COREIMAGE_LOADER
+ //#define JUCE_USE_COREIMAGE_LOADER 1
+#endif
+
+#ifndef    JUCE_DISABLE_COREGRAPHICS_FONT_SMOOTHING
+ //#define JUCE_DISABLE_COREGRAPHICS_FONT_SMOOTHING 0
+#endif
+
+//==============================================================================
+// squarepine_core flags:
+
+#ifndef    SQUAREPINE_COMPILE_UNIT_TESTS
+ //#define SQUAREPINE_COMPILE_UNIT_TESTS 0
+#endif
+
+#ifndef    SQUAREPINE_ARRAY_ITERATION_UNROLLER_MAKE_LINEAR
+ //#define SQUAREPINE_ARRAY_ITERATION_UNROLLER_MAKE_LINEAR 0
+#endif
+
+#ifndef    SQUAREPINE_ARRAY_ITERATION_UNROLLER_CHECK_BIG_NUMS
+ //#define SQUAREPINE_ARRAY_ITERATION_UNROLLER_CHECK_BIG_NUMS 0
+#endif
+
+#ifndef    SQUAREPINE_LOG_NETWORK_CALLS
+ //#define SQUAREPINE_LOG_NETWORK_CALLS 1
+#endif
+
+#ifndef    SQUAREPINE_AUTOCONFIG_MAIN_THREAD_LOG_FILTERS
+ //#define SQUAREPINE_AUTOCONFIG_MAIN_THREAD_LOG_FILTERS 0
+#endif
+
+#ifndef    SQUAREPINE_AUTOLOG_FUNCTION_AND_LINE
+ //#define SQUAREPINE_AUTOLOG_FUNCTION_AND_LINE 0
+#endif
+
+#ifndef    SQUAREPINE_USE_GOOGLE_ANALYTICS
+ //#define SQUAREPINE_USE_GOOGLE_ANALYTICS 1
+#endif
+
+#ifndef    SQUAREPINE_LOG_GOOGLE_ANALYTICS
+ //#define SQUAREPINE_LOG_GOOGLE_ANALYTICS 0
+#endif
+
+#ifndef    SQUAREPINE_ONLY_LOG_GOOGLE_ANALYTICS
+ //#define SQUAREPINE_ONLY_LOG_GOOGLE_ANALYTICS 0
+#endif
+
+//==============================================================================
+#ifndef    JUCE_STANDALONE_APPLICATION
+ #if defined(JucePlugin_Name) && defined(JucePlugin_Build_Standalone)
+  #define  JUCE_STANDALONE_APPLICATION JucePlugin_Build_Standalone
+ #else
+  #define  JUCE_STANDALONE_APPLICATION 1
+ #endif
+#endif
@@ -0,0 +1,774 @@
+#include <JuceHeader.h>
+
+using namespace darkEngine;
+
+//==============================================================================
+/** Measures how a SessionHost copes with many concurrent sessions.
+
+    Each session behaves like a client: it posts its next command
+    as soon as the previous one is answered.
+*/
+class SessionBenchmark final
+{
+public:
+    SessionBenchmark (int numWorkersToUse, int numSessionsToUse, int commandsPerSessionToUse) :
+        host (numWorkersToUse),
+        numSessions (numSessionsToUse),
+        commandsPerSession (commandsPerSessionToUse),
+        latencies ((size_t) numSessions * (size_t) commandsPerSession),
+        numRemaining (numSessions * commandsPerSession)
+    {
+    }
+
+    /** @returns false if any command failed. */
+    bool run()
+    {
+        auto startTime = Time::getMillisecondCounterHiRes();
+
+        sessionIds.reserve ((size_t) numSessions);
+
+        for (int i = 0; i < numSessions; ++i)
+            sessionIds.push_back (host.createSession ([] (GameProcessor& processor)
+            {
+                processor.getCommands().add ("wait", GameCommandIDs::userCommand, [&processor] (const CommandTokenizer&, int)
+                {
+                    processor.advanceTick();
+                    return Result::ok();
+                });
+            }));
+
+        host.waitUntilIdle();
+        const auto setupMs = Time::getMillisecondCounterHiRes() - startTime;
+
+        startTime = Time::getMillisecondCounterHiRes();
+
+        for (int i = 0; i < numSessions; ++i)
+            postNext (i, 0);
+
+        done.wait (-1);
+        const auto elapsedMs = Time::getMillisecondCounterHiRes() - startTime;
+        host.waitUntilIdle(); // Lets the last reply finish with this before it goes.
+
+        std::sort (latencies.begin(), latencies.end());
+
+        const auto percentile = [this] (double p)
+        {
+            return latencies[(size_t) ((double) (latencies.size() - 1) * p)];
+        };
+
+        const auto numCommands = (double) latencies.size();
+
+        std::cout << numSessions << " sessions on " << host.getNumWorkers() << " workers, "
+                  << commandsPerSession << " commands each\n"
+                  << "  setup:      " << String (setupMs, 1) << " ms\n"
+                  << "  commands:   " << String (elapsedMs, 1) << " ms ("
+                  << String (numCommands / jmax (1.0e-9, elapsedMs / 1000.0), 0) << " commands/s)\n"
+                  << "  latency:    p50 " << String (percentile (0.5) * 1000.0, 1)
+                  << " us, p99 " << String (percentile (0.99) * 1000.0, 1)
+                  << " us, max " << String (latencies.back() * 1000.0, 1) << " us\n"
+                  << "  failed:     " << numFailed.load() << "\n";
+
+        return numFailed.load() == 0;
+    }
+
+private:
+    SessionHost host;
+    const int numSessions, commandsPerSession;
+
+    std::vector<SessionHost::SessionId> sessionIds;
+    std::vector<double> latencies; // In milliseconds, each written by one reply only.
+    std::atomic<int> numRemaining, numFailed { 0 };
+    WaitableEvent done;
+
+    void postNext (int sessionIndex, int commandIndex)
+    {
+        const auto postTime = Time::getMillisecondCounterHiRes();
+
+        host.post (sessionIds[(size_t) sessionIndex], "wait",
+                   [this, sessionIndex, commandIndex, postTime] (SessionHost::SessionId, const Result& r)
+        {
+            latencies[(size_t) commandIndex * (size_t) numSessions + (size_t) sessionIndex]
+                = Time::getMillisecondCounterHiRes() - postTime;
+
+            if (r.failed())
+                ++numFailed;
+
+            if (commandIndex + 1 < commandsPerSession)
+                postNext (sessionIndex, commandIndex + 1);
+
+            if (--numRemaining == 0)
+                done.signal();
+        });
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (SessionBenchmark)
+};
+
+//==============================================================================
+/** Times the engine's hot paths against what they replaced, on a single thread,
+    reporting the mean time per operation of each so that they can be compared
+    on the machine at hand.
+*/
+class MicroBenchmarks final
+{
+public:
+    explicit MicroBenchmarks (int numIterationsToUse) :
+        numIterations (jmax (1, numIterationsToUse))
+    {
+    }
+
+    /** The names of the cases that can be run. */
+    static StringArray getNames()       { return { "properties", "snapshot", "verbs", "tokenizer" }; }
+
+    /** @returns false if there's no such case. */
+    bool run (const String& name)
+    {
+        std::cout << name << " (" << numIterations << " iterations)\n";
+
+        if (name == "properties")   { runProperties(); return true; }
+        if (name == "snapshot")     { runSnapshot(); return true; }
+        if (name == "verbs")        { runVerbs(); return true; }
+        if (name == "tokenizer")    { runTokenizer(); return true; }
+
+        return false;
+    }
+
+private:
+    const int numIterations;
+    int64 sink = 0; // Printed at the end, so that the work can't be optimised away.
+
+    //==============================================================================
+    /** Runs the function the number of times, after a warm-up call,
+        and prints the mean time per call.
+    */
+    template<typename Function>
+    void measure (const String& label, int numCalls, Function&& function)
+    {
+        function (0);
+
+        const auto start = Time::getHighResolutionTicks();
+
+        for (int i = 0; i < numCalls; ++i)
+            function (i);
+
+        const auto seconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+        const auto nanoseconds = seconds * 1.0e9 / (double) numCalls;
+
+        std::cout << "  " << label.paddedRight (' ', 32) << String (nanoseconds, 1) << " ns/op ("
+                  << String ((double) numCalls / jmax (1.0e-9, seconds), 0) << " ops/s)\n";
+    }
+
+    /** @see measure */
+    template<typename Function>
+    void measure (const String& label, Function&& function)
+    {
+        measure (label, numIterations, std::forward<Function> (function));
+    }
+
+    void printSink() const
+    {
+        std::cout << "  (checksum " << sink << ")\n";
+    }
+
+    //==============================================================================
+    /** Setting one property of a tree with as many cached properties as a FightableEntity,
+        then reading its cache: through one CachedValue per property, each of which
+        listens to the tree, and through CachedProperty members behind a PropertyDispatcher.
+    */
+    void runProperties()
+    {
+        constexpr int numProperties = 24;
+
+        Array<Identifier> ids;
+
+        for (int i = 0; i < numProperties; ++i)
+            ids.add ("property" + String (i));
+
+        {
+            ValueTree tree ("Object");
+            OwnedArray<CachedValue<int>> caches;
+
+            for (const auto& id : ids)
+                caches.add (new CachedValue<int>())->referTo (tree, id, nullptr, 0);
+
+            measure ("CachedValue", [&] (int i)
+            {
+                tree.setProperty (ids.getReference (i % numProperties), i, nullptr);
+                sink += caches.getUnchecked (i % numProperties)->get();
+            });
+        }
+
+        {
+            ValueTree tree ("Object");
+            PropertyDispatcher dispatcher;
+            OwnedArray<CachedProperty<int>> caches;
+
+            for (const auto& id : ids)
+                dispatcher.bind (*caches.add (new CachedProperty<int>()), tree, id, 0);
+
+            measure ("CachedProperty + dispatcher", [&] (int i)
+            {
+                tree.setProperty (ids.getReference (i % numProperties), i, nullptr);
+                sink += caches.getUnchecked (i % numProperties)->get();
+            });
+        }
+
+        printSink();
+    }
+
+    /** Saving and loading a map with a thousand world objects, in memory,
+        as a BinarySnapshot, as XML and as JSON.
+        Each operation is a whole save then load, so this runs a thousandth as many.
+    */
+    void runSnapshot()
+    {
+        GameMap map;
+        map.addTestData();
+
+        const auto state = map.getState().createCopy();
+        auto world = state.getChildWithName (worldId);
+
+        for (int i = 0; world.getNumChildren() < 1000; ++i)
+            world.appendChild (world.getChild (i).createCopy(), nullptr);
+
+        const auto numCalls = jmax (1, numIterations / 1000);
+
+        {
+            MemoryOutputStream output;
+            BinarySnapshot::write (state, output);
+            std::cout << "  binary is " << (int64) output.getDataSize() << " bytes\n";
+
+            measure ("BinarySnapshot", numCalls, [&] (int)
+            {
+                MemoryOutputStream out;
+                BinarySnapshot::write (state, out);
+                sink += BinarySnapshot::read (out.getData(), out.getDataSize()).getNumChildren();
+            });
+        }
+
+        {
+            XmlElement::TextFormat format;
+            format.lineWrapLength = 4096;
+            std::cout << "  XML is " << state.toXmlString (format).getNumBytesAsUTF8() << " bytes\n";
+
+            measure ("XML", numCalls, [&] (int)
+            {
+                sink += ValueTree::fromXml (state.toXmlString (format)).getNumChildren();
+            });
+        }
+
+        {
+            std::cout << "  JSON is " << sp::toJSONString (state).getNumBytesAsUTF8() << " bytes\n";
+
+            measure ("JSON", numCalls, [&] (int)
+            {
+                sink += createValueTreeFromJSON (sp::toJSONString (state), state.getType()).getNumChildren();
+            });
+        }
+
+        printSink();
+    }
+
+    /** Recognising a token as a verb, or not, through the VerbTable
+        and through a case-insensitive scan of verbs[].
+        Half of the tokens are verbs, in mixed case, and half aren't.
+    */
+    void runVerbs()
+    {
+        StringArray tokens;
+
+        for (int i = 0; i < VerbTable::numVerbs; i += 37)
+        {
+            tokens.add (String (verbs[i]).toUpperCase());
+            tokens.add (String (verbs[i]) + "zz");
+        }
+
+        measure ("VerbTable::find", [&] (int i)
+        {
+            sink += VerbTable::find (tokens[i % tokens.size()]);
+        });
+
+        measure ("linear scan", [&] (int i)
+        {
+            const auto& token = tokens[i % tokens.size()];
+            auto index = VerbTable::notFound;
+
+            for (int v = 0; v < VerbTable::numVerbs; ++v)
+            {
+                if (token.equalsIgnoreCase (verbs[v]))
+                {
+                    index = v;
+                    break;
+                }
+            }
+
+            sink += index;
+        });
+
+        printSink();
+    }
+
+    /** Splitting typed commands into tokens, with the CommandTokenizer and with
+        a lower-cased StringArray like processMessage used to, then carrying out
+        the whole command with a GameProcessor, where ops/s is commands/s.
+    */
+    void runTokenizer()
+    {
+        const char* const commands[] =
+        {
+            "move north",
+            "MOVE   north ",
+            "help",
+            "player set level 10",
+            "take 'old brass key'",
+            "add \"rusty sword\" 4 2",
+            "exit",
+            "look"
+        };
+
+        constexpr auto numCommands = (int) std::size (commands);
+
+        std::vector<String> strings;
+
+        for (const auto* c : commands)
+            strings.emplace_back (c);
+
+        measure ("StringArray::fromTokens", [&] (int i)
+        {
+            auto tokens = StringArray::fromTokens (strings[(size_t) (i % numCommands)].toLowerCase(), " ", "\"'");
+            tokens.trim();
+            tokens.removeEmptyStrings (true);
+            sink += tokens.size();
+        });
+
+        CommandTokenizer tokenizer;
+
+        measure ("CommandTokenizer", [&] (int i)
+        {
+            tokenizer.tokenize (commands[i % numCommands]);
+            sink += tokenizer.size();
+        });
+
+        GameProcessor processor;
+
+        measure ("GameProcessor::processMessage", [&] (int i)
+        {
+            sink += processor.processMessage (commands[i % numCommands]).wasOk() ? 1 : 0;
+        });
+
+        printSink();
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (MicroBenchmarks)
+};
+
+//==============================================================================
+/** Drives a GameProcessor from a script file or stdin, without any UI,
+    so that sessions can be run in bulk on machines without a display.
+
+    Each line is a command, except for:
+    - Empty lines and lines starting with '#', which are skipped.
+    - ":tick [n]", which advances the game by n ticks (or 1).
+
+    @code
+        TheDarkFableHeadless [--script <file>] [--content <folder>] [--seed <n>]
+                             [--record <journal>] [--replay <journal>] [--quiet]
+        TheDarkFableHeadless --serve <socket> [--workers <n>]
+        TheDarkFableHeadless --benchmark <sessions> [--commands <n>] [--workers <n>]
+        TheDarkFableHeadless --microbenchmark <case|all> [--iterations <n>]
+        TheDarkFableHeadless --check-content <folder>
+        TheDarkFableHeadless --check-world
+        TheDarkFableHeadless --simulate <battles> --content <folder> [--build <name>] [--turns <n>] [--seed <n>]
+    @endcode
+*/
+class HeadlessRunner final
+{
+public:
+    HeadlessRunner (const ArgumentList& argsToUse) :
+        args (argsToUse),
+        quiet (args.containsOption ("--quiet|-q"))
+    {
+    }
+
+    //==============================================================================
+    int run()
+    {
+        if (args.containsOption ("--help|-h"))
+        {
+            printUsage();
+            return 0;
+        }
+
+        if (args.containsOption ("--check-content"))
+            return checkContent (args.getFileForOption ("--check-content"));
+
+        if (args.containsOption ("--check-world"))
+            return checkWorld();
+
+        if (const auto content = args.getValueForOption ("--content|-c"); content.isNotEmpty())
+        {
+            if (const auto r = processor.loadContent (args.getFileForOption ("--content|-c")); r.failed())
+                return fail (r.getErrorMessage());
+        }
+
+        if (args.containsOption ("--seed"))
+            processor.setSeed (args.getValueForOption ("--seed").getLargeIntValue());
+
+        if (args.containsOption ("--replay"))
+            return replay (args.getFileForOption ("--replay"));
+
+        if (args.containsOption ("--serve"))
+            return serve (args.getFileForOption ("--serve"));
+
+        if (args.containsOption ("--benchmark"))
+            return benchmark (args.getValueForOption ("--benchmark").getIntValue());
+
+        if (args.containsOption ("--microbenchmark"))
+            return microbenchmark (args.getValueForOption ("--microbenchmark"));
+
+        if (args.containsOption ("--simulate"))
+            return simulate (args.getValueForOption ("--simulate").getIntValue());
+
+        CommandJournal journal (processor.getSeed());
+
+        if (args.containsOption ("--record"))
+        {
+            auto output = args.getFileForOption ("--record").createOutputStream();
+            if (output == nullptr)
+                return fail ("Couldn't open the journal to record to.");
+
+            output->setPosition (0);
+            output->truncate();
+
+            journal.startWritingTo (std::move (output));
+            processor.startRecording (journal);
+        }
+
+        const auto startTime = Time::getMillisecondCounterHiRes();
+
+        if (args.containsOption ("--script|-s"))
+        {
+            const auto script = args.getFileForOption ("--script|-s");
+            FileInputStream input (script);
+
+            if (! input.openedOk())
+                return fail ("Couldn't open the script: " + script.getFullPathName());
+
+            while (! input.isExhausted())
+                runLine (input.readNextLine());
+        }
+        else
+        {
+            for (std::string line; std::getline (std::cin, line);)
+                runLine (String::fromUTF8 (line.data(), (int) line.size()));
+        }
+
+        processor.stopRecording();
+        journal.stopWriting();
+        printSummary (Time::getMillisecondCounterHiRes() - startTime);
+        return numFailed > 0 ? 1 : 0;
+    }
+
+private:
+    //==============================================================================
+    const ArgumentList& args;
+    const bool quiet;
+
+    GameProcessor processor;
+    int numCommands = 0, numFailed = 0;
+
+    //==============================================================================
+    void runLine (const String& line)
+    {
+        const auto trimmed = line.trim();
+
+        if (trimmed.isEmpty() || trimmed.startsWithChar ('#'))
+            return;
+
+        if (trimmed.startsWithChar (':'))
+        {
+            runDirective (trimmed.substring (1));
+            return;
+        }
+
+        const auto r = processor.processMessage (trimmed);
+        ++numCommands;
+
+        if (r.failed())
+            ++numFailed;
+
+        if (! quiet)
+            std::cout << "> " << trimmed << "\n"
+                      << (r.wasOk() ? String ("ok") : r.getErrorMessage()) << "\n";
+    }
+
+    void runDirective (const String& directive)
+    {
+        const auto name = directive.upToFirstOccurrenceOf (" ", false, false);
+
+        if (name == "tick")
+        {
+            const auto numTicks = jmax (1, directive.fromFirstOccurrenceOf (" ", false, false).getIntValue());
+
+            for (int i = 0; i < numTicks; ++i)
+                processor.advanceTick();
+
+            return;
+        }
+
+        std::cerr << "Unknown directive: " << directive << "\n";
+    }
+
+    int replay (const File& source)
+    {
+        CommandJournal journal;
+
+        if (const auto r = journal.load (source); r.failed())
+            return fail (r.getErrorMessage());
+
+        const auto startTime = Time::getMillisecondCounterHiRes();
+
+        numCommands = journal.size();
+        numFailed = processor.replay (journal);
+
+        printSummary (Time::getMillisecondCounterHiRes() - startTime);
+        return 0;
+    }
+
+    int getNumWorkers() const
+    {
+        if (args.containsOption ("--workers"))
+            return jmax (1, args.getValueForOption ("--workers").getIntValue());
+
+        return SystemStats::getNumCpus();
+    }
+
+    /** Serves a session per client over a Unix-domain socket, until stdin is closed. */
+    int serve (const File& socketFile)
+    {
+       #if JUCE_LINUX || JUCE_MAC || JUCE_BSD
+        SessionHost host (getNumWorkers());
+        SessionSocketServer server (host);
+
+        if (const auto r = server.start (socketFile); r.failed())
+            return fail (r.getErrorMessage());
+
+        std::cerr << "Serving sessions on " << socketFile.getFullPathName()
+                  << " with " << host.getNumWorkers() << " workers, until stdin is closed.\n";
+
+        for (std::string line; std::getline (std::cin, line);)
+            std::cerr << server.getNumConnections() << " clients, " << host.getNumSessions() << " sessions\n";
+
+        server.stop();
+        return 0;
+       #else
+        ignoreUnused (socketFile);
+        return fail ("Serving over a socket isn't supported on this platform.");
+       #endif
+    }
+
+    /** Plays many sessions at once, each with one command in flight at a time like a client would,
+        and reports the throughput and the latency between posting a command and its reply.
+    */
+    int benchmark (int numSessions)
+    {
+        if (numSessions <= 0)
+            return fail ("The number of sessions to benchmark must be positive.");
+
+        const auto commandsPerSession = args.containsOption ("--commands")
+                                      ? jmax (1, args.getValueForOption ("--commands").getIntValue())
+                                      : 10;
+
+        SessionBenchmark bench (getNumWorkers(), numSessions, commandsPerSession);
+        return bench.run() ? 0 : 1;
+    }
+
+    /** Loads a content folder, like the shipped "content/TheDarkFable", and checks
+        that the engine can read every definition in it.
+    */
+    int checkContent (const File& contentFolder)
+    {
+        if (! contentFolder.isDirectory())
+            return fail ("There's no content folder at " + contentFolder.getFullPathName());
+
+        auto& map = processor.getCurrentMap();
+
+        if (const auto r = processor.loadContent (contentFolder); r.failed())
+            return fail (r.getErrorMessage());
+
+        for (const auto& category : map.getDefinitionsState())
+            std::cout << category.getType().toString() << ": " << category.getNumChildren() << " definitions\n";
+
+        if (const auto r = ContentLoader::validate (map); r.failed())
+            return fail (r.getErrorMessage());
+
+        std::cout << "ok\n";
+        return 0;
+    }
+
+    /** Checks the test tiles of the map that the processor starts on,
+        like that a wall of GameMap::addTestData() hides what's behind it.
+    */
+    int checkWorld()
+    {
+        auto& map = processor.getCurrentMap();
+        const auto wall = GameMap::testWallPosition;
+
+        if (! map.getTileGrid().getTile (wall).isOpaque())
+            return fail ("There's no wall in the tile grid at " + wall.toString() + ".");
+
+        processor.player.setPosition (wall.withY (0));
+
+        if (! map.canPlayerSee (wall))
+            return fail ("The player can't see the wall from " + processor.player.getPosition().toString() + ".");
+
+        if (map.canPlayerSee (wall.translated (0, 1)))
+            return fail ("The player can see through the wall at " + wall.toString() + ".");
+
+        std::cout << "ok\n";
+        return 0;
+    }
+
+    /** Runs one of the MicroBenchmarks, or all of them. */
+    int microbenchmark (const String& name)
+    {
+        const auto numIterations = args.containsOption ("--iterations")
+                                 ? args.getValueForOption ("--iterations").getIntValue()
+                                 : 1000000;
+
+        MicroBenchmarks bench (numIterations);
+
+        if (name == "all")
+        {
+            for (const auto& n : MicroBenchmarks::getNames())
+                bench.run (n);
+
+            return 0;
+        }
+
+        if (! bench.run (name))
+            return fail ("There's no microbenchmark named " + name.quoted() + ", try one of: "
+                         + MicroBenchmarks::getNames().joinIntoString (", ") + ", all.");
+
+        return 0;
+    }
+
+    /** Pits the player, or a definition from the content, against every enemy of the content,
+        and reports how each enemy fares.
+    */
+    int simulate (int battlesPerEnemy)
+    {
+        if (battlesPerEnemy <= 0)
+            return fail ("The number of battles to simulate must be positive.");
+
+        auto build = processor.player.getState();
+
+        if (args.containsOption ("--build"))
+        {
+            const auto buildName = args.getValueForOption ("--build");
+            build = processor.getCurrentMap().findDefinition (buildName);
+
+            if (! build.isValid())
+                return fail ("There's no definition named " + buildName.quoted() + ".");
+        }
+
+        const auto enemies = processor.getCurrentMap().getEnemiesState();
+        if (enemies.getNumChildren() == 0)
+            return fail ("There are no enemies to fight: use --content to load some.");
+
+        BattleSimulator::Options options;
+        options.battlesPerEnemy = battlesPerEnemy;
+        options.seed = processor.getSeed();
+
+        if (args.containsOption ("--turns"))
+            options.maxTurns = jmax (1, args.getValueForOption ("--turns").getIntValue());
+
+        BattleSimulator simulator (getNumWorkers());
+
+        const auto startTime = Time::getMillisecondCounterHiRes();
+        const auto reports = simulator.run (build, enemies, options);
+        const auto elapsedMs = Time::getMillisecondCounterHiRes() - startTime;
+
+        const auto printBuckets = [] (const auto& buckets)
+        {
+            String s;
+
+            for (const auto count : buckets)
+                s << " " << String (count);
+
+            return s;
+        };
+
+        int64 numBattles = 0;
+
+        for (const auto& report : reports)
+        {
+            numBattles += report.numBattles;
+
+            std::cout << report.enemyName << "\n"
+                      << "  won:        " << String (report.getWinRate() * 100.0, 2) << "% ("
+                      << report.numWins << " won, " << report.numLosses << " lost, " << report.numDraws << " drawn)\n"
+                      << "  turns:      mean " << String (report.getMeanTurnsToKill(), 2)
+                      << ", p50 " << report.getTurnsToKillPercentile (0.5)
+                      << ", p90 " << report.getTurnsToKillPercentile (0.9) << "\n"
+                      << "  hp on win:  " << printBuckets (report.remainingHitPointsOnWin) << "\n"
+                      << "  hp on loss: " << printBuckets (report.enemyHitPointsOnLoss) << "\n";
+        }
+
+        std::cerr << numBattles << " battles in " << String (elapsedMs, 1) << " ms ("
+                  << String ((double) numBattles / jmax (1.0e-9, elapsedMs / 1000.0), 0) << " battles/s)\n";
+        return 0;
+    }
+
+    //==============================================================================
+    void printSummary (double elapsedMs) const
+    {
+        const auto seconds = jmax (1.0e-9, elapsedMs / 1000.0);
+
+        std::cerr << numCommands << " commands, "
+                  << numFailed << " failed, "
+                  << processor.getTick() << " ticks, "
+                  << String (elapsedMs, 3) << " ms ("
+                  << String (numCommands / seconds, 0) << " commands/s)\n";
+    }
+
+    static void printUsage()
+    {
+        std::cout << "Usage: TheDarkFableHeadless [--script <file>] [--content <folder>] [--seed <n>]\n"
+                     "                            [--record <journal>] [--replay <journal>] [--quiet]\n"
+                     "       TheDarkFableHeadless --serve <socket> [--workers <n>]\n"
+                     "       TheDarkFableHeadless --benchmark <sessions> [--commands <n>] [--workers <n>]\n"
+                     "       TheDarkFableHeadless --microbenchmark <case|all> [--iterations <n>]\n"
+                     "       TheDarkFableHeadless --check-content <folder>\n"
+                     "       TheDarkFableHeadless --check-world\n"
+                     "       TheDarkFableHeadless --simulate <battles> --content <folder> [--build <name>] [--turns <n>] [--seed <n>]\n"
+                     "\n"
+                     "Runs commands from the script, or stdin, one per line.\n"
+                     "Lines starting with '#' are skipped, and \":tick [n]\" advances the game by n ticks.\n"
+                     "\n"
+                     "--serve gives each client of the Unix-domain socket its own session.\n"
+                     "--benchmark plays many sessions at once and reports throughput and latency.\n"
+                     "--microbenchmark times one of the engine's hot paths against what it replaced:\n"
+                     "  " + MicroBenchmarks::getNames().joinIntoString (", ").toStdString() + ".\n"
+                     "--check-content loads a content folder and checks that every definition can be read.\n"
+                     "--check-world checks that the walls of the starting map block the player's sight.\n"
+                     "--simulate pits the player (or --build) against every enemy, on every core,\n"
+                     "and reports win rates, turns to kill and the remaining hit points, in tenths.\n";
+    }
+
+    static int fail (const String& message)
+    {
+        std::cerr << message << "\n";
+        return 2;
+    }
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE (HeadlessRunner)
+};
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    const ArgumentList args (argc, argv);
+    return HeadlessRunner (args).run();
+}